@@ -0,0 +1,139 @@
+/**
+ * @file AssignmentCache.h
+ *
+ * Small fixed-size cache of solved post assignments keyed by the quantized
+ * team state (agent poses, ball cell, formation, leader)
+ *
+ * The cache is set associative: the hash of the key selects a set of a few
+ * entries, which are compared and replaced least recently used first. So
+ * lookups and inserts take constant time and no memory is allocated once
+ * the entries are in use.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Streams/Streamable.h"
+#include <cstdint>
+#include <vector>
+
+class AssignmentCacheStats : public Streamable
+{
+public:
+	unsigned hits = 0;
+	unsigned misses = 0;
+	unsigned evictions = 0; /*< valid entries replaced by newer ones */
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(hits);
+		STREAM(misses);
+		STREAM(evictions);
+		STREAM_REGISTER_FINISH;
+	}
+};
+
+class AssignmentCache
+{
+public:
+	/**
+	 * Looks up the assignment of a state
+	 * @param key quantized team state
+	 * @param permutation the cached post per agent if found
+	 * @param cost the cached cost of the assignment if found
+	 * @return whether the state was found
+	 */
+	bool lookup(const std::vector<int>& key, std::vector<int>& permutation, float& cost)
+	{
+		const uint64_t h = hash(key);
+		Entry* set = entries + (h % numOfSets) * ways;
+		for(size_t w = 0; w < ways; w++)
+			if(set[w].valid && set[w].hash == h && set[w].key == key)
+			{
+				set[w].lastUse = ++clock;
+				permutation = set[w].permutation;
+				cost = set[w].cost;
+				stats.hits++;
+				return true;
+			}
+		stats.misses++;
+		return false;
+	}
+
+	/**
+	 * Whether a state is cached, without counting it as a use
+	 */
+	bool contains(const std::vector<int>& key) const
+	{
+		const uint64_t h = hash(key);
+		const Entry* set = entries + (h % numOfSets) * ways;
+		for(size_t w = 0; w < ways; w++)
+			if(set[w].valid && set[w].hash == h && set[w].key == key)
+				return true;
+		return false;
+	}
+
+	/**
+	 * Stores the assignment of a state, replacing the least recently used entry of its set
+	 */
+	void insert(const std::vector<int>& key, const std::vector<int>& permutation, float cost)
+	{
+		const uint64_t h = hash(key);
+		Entry* set = entries + (h % numOfSets) * ways;
+		Entry* victim = set;
+		for(size_t w = 1; w < ways; w++)
+			if(!set[w].valid || (victim->valid && set[w].lastUse < victim->lastUse))
+				victim = set + w;
+
+		stats.evictions += victim->valid;
+		victim->valid = true;
+		victim->hash = h;
+		victim->key = key;
+		victim->permutation = permutation;
+		victim->cost = cost;
+		victim->lastUse = ++clock;
+	}
+
+	void clear()
+	{
+		for(Entry& entry : entries)
+			entry.valid = false;
+	}
+
+	AssignmentCacheStats stats;
+
+private:
+	static const size_t numOfSets = 16;
+	static const size_t ways = 4;
+
+	struct Entry
+	{
+		bool valid = false;
+		uint64_t hash = 0;
+		std::vector<int> key;
+		std::vector<int> permutation;
+		float cost = 0.f;
+		unsigned lastUse = 0;
+	};
+
+	/**
+	 * FNV-1a over the key
+	 */
+	static uint64_t hash(const std::vector<int>& key)
+	{
+		uint64_t h = 14695981039346656037ull;
+		for(int value : key)
+			for(int byte = 0; byte < 4; byte++)
+			{
+				h ^= (uint64_t)(((unsigned)value >> (8 * byte)) & 0xff);
+				h *= 1099511628211ull;
+			}
+		return h;
+	}
+
+	Entry entries[numOfSets * ways];
+	unsigned clock = 0;
+};
@@ -0,0 +1,110 @@
+/**
+ * @file AssignmentCertificate.h
+ *
+ * Certifies that the last optimal post assignment is still optimal for a
+ * changed cost matrix, so it doesn't need to be solved again.
+ *
+ * The reduced costs r(i, j) = c(i, j) - u[i] - v[j] >= 0 of the dual
+ * potentials of the last solve are the slack of each entry, they are 0 for
+ * the entries of the assignment σ. If the costs change by d(i, j), raising
+ * u[i] by the change d(i, σ(i)) of the assigned entry of the row keeps these
+ * tight, and the potentials stay feasible as long as
+ *     r(i, j) + d(i, j) - d(i, σ(i)) >= 0
+ * for all entries. Then σ is still optimal by duality. A robot walking
+ * changes its whole row by about the same amount, which mostly cancels out.
+ * The changes are measured against the costs of the last solve, so small
+ * changes can't add up unnoticed over the frames.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Streams/Streamable.h"
+#include <vector>
+
+class AssignmentCertificateStats : public Streamable
+{
+public:
+	unsigned certifiedUnchanged = 0; /*< frames the assignment was certified without solving */
+	unsigned solved = 0; /*< frames the assignment had to be solved */
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(certifiedUnchanged);
+		STREAM(solved);
+		STREAM_REGISTER_FINISH;
+	}
+};
+
+class AssignmentCertificate
+{
+public:
+	typedef std::vector<std::vector<float> > Matrix;
+
+	/**
+	 * Stores an optimal assignment
+	 * @param key what the costs are of (formation, leader, agents), a different key is never certified
+	 * @param costs the costs the assignment was solved for
+	 * @param reducedCosts reduced costs of the solve, infinite for excluded entries
+	 * @param permutation the optimal post per agent
+	 */
+	void certify(const std::vector<int>& key, const Matrix& costs, const Matrix& reducedCosts,
+			const std::vector<int>& permutation)
+	{
+		this->key = key;
+		this->costs = costs;
+		this->reducedCosts = reducedCosts;
+		this->permutation = permutation;
+	}
+
+	/**
+	 * Whether the stored assignment is optimal for new costs as well
+	 * @param permutation the stored assignment if so
+	 */
+	bool covers(const std::vector<int>& key, const Matrix& costs, std::vector<int>& permutation) const
+	{
+		if(key != this->key || costs.size() != this->costs.size())
+			return false;
+
+		for(size_t i = 0; i < costs.size(); i++)
+		{
+			const int assigned = this->permutation[i];
+			const float rowChange = costs[i][assigned] - this->costs[i][assigned];
+			for(size_t j = 0; j < costs[i].size(); j++)
+				if(!(reducedCosts[i][j] + (costs[i][j] - this->costs[i][j]) - rowChange >= 0.f))
+					return false;
+		}
+
+		permutation = this->permutation;
+		return true;
+	}
+
+	/**
+	 * Whether an assignment of this key is stored, whatever the costs are now
+	 */
+	bool holds(const std::vector<int>& key) const
+	{
+		return !key.empty() && key == this->key;
+	}
+
+	bool empty() const
+	{
+		return key.empty();
+	}
+
+	void clear()
+	{
+		key.clear();
+	}
+
+	AssignmentCertificateStats stats;
+
+private:
+	std::vector<int> key;
+	Matrix costs;
+	Matrix reducedCosts;
+	std::vector<int> permutation;
+};
@@ -0,0 +1,208 @@
+/**
+ * @file AuctionAssignment.h
+ *
+ * Distributed assignment of robots to posts by an auction (Bertsekas). Every
+ * robot only knows its own costs to the posts. It keeps a view of the price
+ * and the highest bidder of each post, bids for its cheapest post whenever it
+ * holds none and sends its view to the others, which merge it into theirs.
+ *
+ * A bid raises the price of the cheapest post (cost + price) by the margin to
+ * the second cheapest one plus epsilon, so each robot holds a post within
+ * epsilon of its cheapest. When all robots hold one post each, the total cost
+ * is at most number of robots * epsilon above the optimum.
+ *
+ * Small epsilons need many bids, so epsilon is scaled down in phases: a robot
+ * that sees a complete assignment starts the next phase, keeping the prices
+ * as a warm start but dropping all bids. Views of a later phase replace the
+ * older ones, views of the same phase are merged post by post, the higher
+ * price wins. Prices never decrease, so lost or late views only delay the
+ * auction.
+ *
+ * If the costs of a robot change, e.g. because a post is excluded for it now,
+ * it gives up the post it holds and bids again. A bid always raises the price,
+ * so at the same price the view without the owner is newer and wins.
+ *
+ * The robots have to agree on the posts and the bidders, which is checked
+ * with a key sent along with the views. Views of another auction are ignored.
+ *
+ * This file only depends on the standard library, it is used by
+ * Util/AuctionSimulator as well.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+class AuctionAssignment
+{
+public:
+	/**
+	 * @param startEpsilon bid increment of the first phase (cost units)
+	 * @param minEpsilon bid increment of the last phase, the assignment costs at most
+	 *        number of robots * minEpsilon more than the optimum
+	 * @param scaling division of epsilon from one phase to the next
+	 */
+	AuctionAssignment(float startEpsilon = 1.f, float minEpsilon = 0.05f, float scaling = 4.f) :
+		startEpsilon(startEpsilon), minEpsilon(std::min(minEpsilon, startEpsilon)), scaling(std::max(scaling, 1.5f))
+	{}
+
+	/**
+	 * Starts a new auction if the posts or the bidders changed
+	 * @param key identifies the posts and the bidders, see hash()
+	 * @param numOfPosts number of posts auctioned
+	 */
+	void start(uint32_t key, size_t numOfPosts)
+	{
+		if(key == currentKey && prices_.size() == numOfPosts)
+			return;
+		currentKey = key;
+		phase_ = 0;
+		prices_.assign(numOfPosts, 0.f);
+		owners_.assign(numOfPosts, 0);
+		held = -1;
+	}
+
+	/**
+	 * Adopts the view of another robot
+	 * @return whether the view belongs to the same auction
+	 */
+	bool merge(uint32_t key, int phase, const std::vector<float>& prices, const std::vector<int>& owners)
+	{
+		if(key != currentKey || prices.size() != prices_.size() || owners.size() != owners_.size() || phase < phase_)
+			return false;
+		if(phase > phase_)
+		{
+			phase_ = phase;
+			prices_ = prices;
+			owners_ = owners;
+			return true;
+		}
+		for(size_t j = 0; j < prices_.size(); j++)
+			if(prices[j] > prices_[j] || (prices[j] == prices_[j] && owners[j] < owners_[j]))
+			{
+				prices_[j] = prices[j];
+				owners_[j] = owners[j];
+			}
+		return true;
+	}
+
+	/**
+	 * Starts the next phase if the assignment is complete, then bids for the
+	 * cheapest post if this robot holds none or the one it holds is not within
+	 * epsilon of the cheapest anymore (the costs changed)
+	 * @param self number of this robot, > 0
+	 * @param costs cost of this robot to each post, INFINITY for excluded ones
+	 * @param bidders numbers of all robots taking part
+	 * @return whether a bid was made
+	 */
+	bool bid(int self, const std::vector<float>& costs, const std::vector<int>& bidders)
+	{
+		if(costs.size() != prices_.size())
+			return false;
+		if(complete(bidders) && epsilon() > minEpsilon)
+		{
+			phase_++;
+			std::fill(owners_.begin(), owners_.end(), 0);
+		}
+
+		float best = std::numeric_limits<float>::infinity();
+		float second = std::numeric_limits<float>::infinity();
+		int bestPost = -1;
+		for(size_t j = 0; j < costs.size(); j++)
+		{
+			const float value = costs[j] + prices_[j];
+			if(value < best)
+			{
+				second = best;
+				best = value;
+				bestPost = (int)j;
+			}
+			else if(value < second)
+				second = value;
+		}
+		if(bestPost < 0)
+			return false;
+
+		const bool holding = held >= 0 && owners_[held] == self;
+		if(holding && costs[held] + prices_[held] <= best + epsilon())
+			return false;
+
+		// give up the post held so far
+		if(holding)
+			owners_[held] = 0;
+
+		// a single post is worth epsilon only
+		prices_[bestPost] += (std::isfinite(second) ? second - best : 0.f) + epsilon();
+		owners_[bestPost] = self;
+		held = bestPost;
+		return true;
+	}
+
+	/**
+	 * Whether every bidder holds exactly one post in this view
+	 */
+	bool complete(const std::vector<int>& bidders) const
+	{
+		for(int bidder : bidders)
+			if(std::count(owners_.begin(), owners_.end(), bidder) != 1)
+				return false;
+		return !bidders.empty();
+	}
+
+	/**
+	 * Whether the assignment is complete in the last phase, i.e. epsilon-optimal
+	 */
+	bool converged(const std::vector<int>& bidders) const { return epsilon() <= minEpsilon && complete(bidders); }
+
+	/**
+	 * The post of a bidder in this view, -1 if none
+	 */
+	int postOf(int bidder) const
+	{
+		const auto i = std::find(owners_.begin(), owners_.end(), bidder);
+		return i == owners_.end() ? -1 : (int)(i - owners_.begin());
+	}
+
+	inline float epsilon() const { return std::max(minEpsilon, startEpsilon / std::pow(scaling, (float)phase_)); }
+	inline uint32_t key() const { return currentKey; }
+	inline int phase() const { return phase_; }
+	inline const std::vector<float>& prices() const { return prices_; }
+	inline const std::vector<int>& owners() const { return owners_; }
+
+	/**
+	 * Adds values to a key (FNV-1a)
+	 */
+	static uint32_t hash(uint32_t key, int value)
+	{
+		for(int i = 0; i < 4; i++)
+			key = (key ^ (uint32_t)((value >> (8 * i)) & 0xff)) * 16777619u;
+		return key;
+	}
+
+	static uint32_t hash(uint32_t key, const std::string& value)
+	{
+		for(char c : value)
+			key = (key ^ (uint32_t)(unsigned char)c) * 16777619u;
+		return key;
+	}
+
+	static const uint32_t emptyKey = 2166136261u;
+
+private:
+	float startEpsilon;
+	float minEpsilon;
+	float scaling;
+
+	uint32_t currentKey = 0; /*< the auction of the view */
+	int phase_ = 0; /*< epsilon scaling phase */
+	std::vector<float> prices_; /*< price of each post */
+	std::vector<int> owners_; /*< highest bidder of each post, 0 if none */
+	int held = -1; /*< the post this robot bid for last */
+};
@@ -0,0 +1,57 @@
+/**
+ * @file AuctionMessageProvider.cpp
+ *
+ * Collects the views of the post auction the teammates sent
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "AuctionMessageProvider.h"
+#include <algorithm>
+
+MAKE_MODULE(AuctionMessageProvider, behaviorControl)
+
+PROCESS_LOCAL AuctionMessageProvider* AuctionMessageProvider::theInstance = nullptr;
+
+AuctionMessageProvider::AuctionMessageProvider()
+{
+	theInstance = this;
+}
+
+AuctionMessageProvider::~AuctionMessageProvider()
+{
+	theInstance = nullptr;
+}
+
+bool AuctionMessageProvider::handleMessage(InMessage& message)
+{
+	if(message.getMessageID() != idAuctionMessage)
+		return false;
+	AuctionMessage auctionMessage;
+	message.bin >> auctionMessage;
+	if(theInstance)
+		theInstance->pending.push_back(auctionMessage);
+	return true;
+}
+
+void AuctionMessageProvider::update(AuctionMessages& auctionMessages)
+{
+	// a newer view replaces the one of the same sender
+	for(const AuctionMessage& message : pending)
+	{
+		auto i = std::find_if(received.begin(), received.end(),
+				[&](const Received& r) { return r.message.sender == message.sender; });
+		if(i == received.end())
+			received.push_back(Received{message, theFrameInfo.time});
+		else
+			*i = Received{message, theFrameInfo.time};
+	}
+	pending.clear();
+
+	received.erase(std::remove_if(received.begin(), received.end(),
+			[&](const Received& r) { return theFrameInfo.getTimeSince(r.time) > maxAge; }), received.end());
+
+	auctionMessages.messages.clear();
+	for(const Received& r : received)
+		auctionMessages.messages.push_back(r.message);
+}
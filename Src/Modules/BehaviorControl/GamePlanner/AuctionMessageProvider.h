@@ -0,0 +1,58 @@
+/**
+ * @file AuctionMessageProvider.h
+ *
+ * Collects the views of the post auction (see AuctionAssignment.h) the
+ * teammates sent with their team messages. The TeamDataProvider hands every
+ * message with the id idAuctionMessage to handleMessage(), the last view of
+ * each sender is kept until it is older than maxAge, i.e. the sender left the
+ * auction or the team.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Module/Module.h"
+#include "Tools/MessageQueue/InMessage.h"
+#include "Representations/Infrastructure/FrameInfo.h"
+#include "Representations/BehaviorControl/AuctionMessage.h"
+
+MODULE(AuctionMessageProvider,
+{,
+	REQUIRES(FrameInfo),
+	PROVIDES(AuctionMessages),
+	LOADS_PARAMETERS(
+	{,
+		(int)(1000)	maxAge,	// time (ms) after which the view of a teammate is dropped
+	}),
+});
+
+class AuctionMessageProvider : public AuctionMessageProviderBase {
+public:
+	AuctionMessageProvider();
+	~AuctionMessageProvider();
+
+	/**
+	 * Main update
+	 */
+	void update(AuctionMessages& auctionMessages);
+
+	/**
+	 * Keeps the auction view of a teammate, called by the TeamDataProvider for
+	 * each message with the id idAuctionMessage
+	 * @return whether the message was handled
+	 */
+	static bool handleMessage(InMessage& message);
+
+private:
+	struct Received
+	{
+		AuctionMessage message;
+		unsigned time; /*< when it was received */
+	};
+
+	std::vector<AuctionMessage> pending; /*< received since the last update */
+	std::vector<Received> received; /*< the last view of each teammate */
+
+	static PROCESS_LOCAL AuctionMessageProvider* theInstance; /*< the only instance in this process, nullptr if there is none */
+};
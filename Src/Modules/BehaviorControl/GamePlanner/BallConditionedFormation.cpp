@@ -0,0 +1,201 @@
+/**
+ * @file BallConditionedFormation.cpp
+ *
+ * Ball-conditioned formation as in "Positioning to Win" (SBSP)
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "BallConditionedFormation.h"
+#include "Delaunay.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+bool BallConditionedFormation::load(const std::string& file, unsigned numOfPosts)
+{
+	std::ifstream stream(file.c_str(), std::ios::in);
+	if(!stream)
+		return false; // ball-conditioned data is optional for a formation
+
+	_numOfPosts = numOfPosts;
+	anchors.clear();
+	samples.clear();
+	triangles.clear();
+
+	std::vector<bool> anchorDefined;
+	std::vector<unsigned> postsDefined;
+
+	std::string line;
+	while(std::getline(stream, line))
+	{
+		line = line.substr(0, line.find('#'));
+		const size_t begin = line.find_first_not_of(" \t");
+		if(begin == std::string::npos)
+			continue;
+
+		const char tag = line[begin];
+		const char* values = line.c_str() + begin + 1;
+		int anchor, post, v0, v1, v2;
+		float x, y;
+
+		if(tag == 'b' && sscanf(values, " , %d , %f , %f", &anchor, &x, &y) == 3 && anchor >= 0)
+		{
+			if((size_t)anchor >= anchors.size())
+			{
+				anchors.resize(anchor + 1, Vector2f::Zero());
+				anchorDefined.resize(anchor + 1, false);
+				samples.resize((anchor + 1) * numOfPosts, Vector2f::Zero());
+				postsDefined.resize(anchor + 1, 0);
+			}
+			anchors[anchor] = Vector2f(x, y);
+			anchorDefined[anchor] = true;
+		}
+		else if(tag == 'p' && sscanf(values, " , %d , %d , %f , %f", &anchor, &post, &x, &y) == 4 &&
+				anchor >= 0 && (size_t)anchor < anchors.size() && post >= 0 && (unsigned)post < numOfPosts)
+		{
+			samples[anchor * numOfPosts + post] = Vector2f(x, y);
+			postsDefined[anchor]++;
+		}
+		else if(tag == 't' && sscanf(values, " , %d , %d , %d", &v0, &v1, &v2) == 3)
+		{
+			Triangle t = {{v0, v1, v2}, {-1, -1, -1}};
+			triangles.push_back(t);
+		}
+		else
+			std::cerr << "[Loading Grid Error] Config \'" << file << "\' invalid line: " << line << "\n";
+	}
+
+	for(size_t i = 0; i < anchors.size(); i++)
+		if(!anchorDefined[i] || postsDefined[i] != numOfPosts)
+		{
+			std::cerr << "[Loading Grid Error] Config \'" << file << "\' anchor " << i << " is incomplete\n";
+			triangles.clear();
+			return false;
+		}
+
+	// drop triangles referring to unknown anchors or without any area
+	triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [this](const Triangle& t)
+	{
+		for(int i = 0; i < 3; i++)
+			if(t.v[i] < 0 || (size_t)t.v[i] >= anchors.size())
+				return true;
+		const Vector2f e0 = anchors[t.v[1]] - anchors[t.v[0]];
+		const Vector2f e1 = anchors[t.v[2]] - anchors[t.v[0]];
+		return e0.x() * e1.y() - e0.y() * e1.x() == 0.f;
+	}), triangles.end());
+
+	if(triangles.empty())
+		triangulate();
+
+	buildNeighbors();
+	return !triangles.empty();
+}
+
+void BallConditionedFormation::triangulate()
+{
+	std::vector<std::array<int, 3> > result;
+	Delaunay::triangulate(anchors, result);
+	triangles.clear();
+	for(const std::array<int, 3>& t : result)
+		triangles.push_back(Triangle{{t[0], t[1], t[2]}, {-1, -1, -1}});
+}
+
+void BallConditionedFormation::buildNeighbors()
+{
+	std::map<std::pair<int, int>, std::pair<int, int> > edges; // edge -> (triangle, opposite vertex)
+	for(size_t i = 0; i < triangles.size(); i++)
+	{
+		Triangle& t = triangles[i];
+		for(int k = 0; k < 3; k++)
+		{
+			t.neighbor[k] = -1;
+			const int a = t.v[(k + 1) % 3], b = t.v[(k + 2) % 3];
+			const std::pair<int, int> edge(std::min(a, b), std::max(a, b));
+			std::map<std::pair<int, int>, std::pair<int, int> >::iterator other = edges.find(edge);
+			if(other == edges.end())
+				edges[edge] = std::make_pair((int)i, k);
+			else
+			{
+				t.neighbor[k] = other->second.first;
+				triangles[other->second.first].neighbor[other->second.second] = (int)i;
+			}
+		}
+	}
+}
+
+Vector3f BallConditionedFormation::barycentric(const Triangle& t, const Vector2f& p) const
+{
+	const Vector2f e0 = anchors[t.v[1]] - anchors[t.v[0]];
+	const Vector2f e1 = anchors[t.v[2]] - anchors[t.v[0]];
+	const Vector2f e2 = p - anchors[t.v[0]];
+	const float area = e0.x() * e1.y() - e1.x() * e0.y();
+	const float w1 = (e2.x() * e1.y() - e1.x() * e2.y()) / area;
+	const float w2 = (e0.x() * e2.y() - e2.x() * e0.y()) / area;
+	return Vector3f(1.f - w1 - w2, w1, w2);
+}
+
+void BallConditionedFormation::locate(const Vector2f& p, Vector3f& weights, int& hint) const
+{
+	int t = hint >= 0 && (size_t)hint < triangles.size() ? hint : 0;
+
+	// the ball moves little between frames, so the walk usually ends in the
+	// start triangle or one of its neighbors
+	for(size_t step = 0; step <= triangles.size(); step++)
+	{
+		weights = barycentric(triangles[t], p);
+		int k;
+		if(weights.minCoeff(&k) >= -1e-6f)
+		{
+			hint = t;
+			return;
+		}
+
+		const int next = triangles[t].neighbor[k];
+		if(next < 0)
+		{
+			// outside of the anchors' hull: project onto the hull edge
+			const Vector2f& a = anchors[triangles[t].v[(k + 1) % 3]];
+			const Vector2f& b = anchors[triangles[t].v[(k + 2) % 3]];
+			const float s = std::max(0.f, std::min(1.f, (p - a).dot(b - a) / (b - a).squaredNorm()));
+			weights[k] = 0.f;
+			weights[(k + 1) % 3] = 1.f - s;
+			weights[(k + 2) % 3] = s;
+			hint = t;
+			return;
+		}
+		t = next;
+	}
+
+	// walk didn't settle (degenerate input), use the clamped weights of the last triangle
+	weights = weights.cwiseMax(0.f);
+	weights /= std::max(weights.sum(), 1e-6f);
+	hint = t;
+}
+
+void BallConditionedFormation::evaluate(const Vector2f& ball, std::vector<Vector2f>& posts, int& hint) const
+{
+	posts.resize(_numOfPosts);
+	if(triangles.empty())
+		return;
+
+	Vector3f w;
+	locate(ball, w, hint);
+
+	const Triangle& t = triangles[hint];
+	const Vector2f* s0 = &samples[t.v[0] * _numOfPosts];
+	const Vector2f* s1 = &samples[t.v[1] * _numOfPosts];
+	const Vector2f* s2 = &samples[t.v[2] * _numOfPosts];
+	for(unsigned i = 0; i < _numOfPosts; i++)
+		posts[i] = w[0] * s0[i] + w[1] * s1[i] + w[2] * s2[i];
+}
+
+void BallConditionedFormation::mirrorY()
+{
+	for(Vector2f& anchor : anchors)
+		anchor.y() = -anchor.y();
+	for(Vector2f& sample : samples)
+		sample.y() = -sample.y();
+}
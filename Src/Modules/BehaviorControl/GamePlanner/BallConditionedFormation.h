@@ -0,0 +1,85 @@
+/**
+ * @file BallConditionedFormation.h
+ *
+ * Ball-conditioned formation as in "Positioning to Win" (SBSP)
+ *
+ * Post positions are stored for a set of ball anchor points. The anchors are
+ * triangulated (Delaunay) and the posts for an arbitrary ball position are
+ * the barycentric blend of the posts of the triangle that contains the ball.
+ *
+ * File format (same base name as the formation, extension .sbsp):
+ *   b, anchor, ballX, ballY          # ball anchor
+ *   p, anchor, post, x, y            # post position for an anchor
+ *   t, anchor0, anchor1, anchor2     # triangle (optional, triangulated on load otherwise)
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Math/Eigen.h"
+#include <string>
+#include <vector>
+
+class BallConditionedFormation
+{
+public:
+	/**
+	 * Loads anchors, posts and the triangulation from file
+	 * @param file path of the .sbsp file
+	 * @param numOfPosts number of posts of the formation it belongs to
+	 * @return false if the file doesn't exist or is inconsistent
+	 */
+	bool load(const std::string& file, unsigned numOfPosts);
+
+	inline bool empty() const { return triangles.empty(); }
+	inline unsigned numOfPosts() const { return _numOfPosts; }
+
+	/**
+	 * Evaluates post positions for the given ball position
+	 * @param ball global ball position
+	 * @param posts resulting global post positions
+	 * @param hint triangle to start the walk from, updated to the triangle found
+	 */
+	void evaluate(const Vector2f& ball, std::vector<Vector2f>& posts, int& hint) const;
+
+	/**
+	 * Mirrors anchors and posts along the x axis
+	 */
+	void mirrorY();
+
+private:
+	struct Triangle
+	{
+		int v[3]; /*< anchor indices */
+		int neighbor[3]; /*< triangle on the other side of the edge opposite to v[i], -1 on the hull */
+	};
+
+	/**
+	 * Delaunay triangulation of the anchors (Bowyer-Watson)
+	 */
+	void triangulate();
+
+	/**
+	 * Fills the neighbor relation of the triangles
+	 */
+	void buildNeighbors();
+
+	/**
+	 * Walking point location starting from the hint triangle
+	 * @param p query point
+	 * @param weights barycentric weights of p in the resulting triangle
+	 * @param hint triangle to start from, updated to the resulting triangle
+	 */
+	void locate(const Vector2f& p, Vector3f& weights, int& hint) const;
+
+	/**
+	 * Barycentric coordinates of p in the triangle
+	 */
+	Vector3f barycentric(const Triangle& t, const Vector2f& p) const;
+
+	unsigned _numOfPosts = 0;
+	std::vector<Vector2f> anchors; /*< ball anchor points */
+	std::vector<Vector2f> samples; /*< posts per anchor, samples[anchor * numOfPosts + post] */
+	std::vector<Triangle> triangles;
+};
@@ -0,0 +1,254 @@
+/**
+ * @file BranchAndBoundAssignment.h
+ *
+ * Exact assignment for objectives with costs between pairs of assignments
+ * (e.g. crossing paths), which are no linear assignment problems anymore.
+ *
+ * The objective is a functor with
+ *     float linear(row, column) const;
+ *     float pair(rowA, columnA, rowB, columnB) const; // rowA < rowB, >= 0
+ * and the total cost of an assignment σ is the sum of linear(i, σ(i)) over all
+ * rows plus pair(i, σ(i), k, σ(k)) over all pairs of rows i < k.
+ *
+ * The search branches on the column of one row after another. The lower bound
+ * of a partial assignment is its cost plus the optimal linear assignment of the
+ * remaining rows, where each entry includes its pairs with the rows already
+ * assigned. The pairs among the remaining rows are left out, so the bound is
+ * admissible. The assignment of that relaxation is a complete solution as
+ * well, which tightens the incumbent early.
+ *
+ * Open subtrees are kept in one deque per thread. A thread expands its own
+ * deque depth first and steals the oldest, i.e. largest, subtrees from the
+ * others when it runs out of work.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/HungarianAssignment.h"
+#include "Tools/Math/Eigen.h"
+#include "Tools/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template<typename Objective> class BranchAndBoundAssignment
+{
+public:
+	/**
+	 * @param n number of rows and columns
+	 * @param objective the costs
+	 * @param pool threads to search on besides the calling one, nullptr to search alone
+	 * @param assignment resulting column of each row
+	 * @return the total cost of the assignment
+	 */
+	static float solve(size_t n, const Objective& objective, ThreadPool* pool, std::vector<int>& assignment)
+	{
+		if(!n)
+		{
+			assignment.clear();
+			return 0.f;
+		}
+
+		Search search(n, objective, pool ? pool->size() + 1 : 1);
+		if(pool)
+			pool->parallelFor(search.deques.size(), [&](size_t thread) { search.work(thread); });
+		else
+			search.work(0);
+
+		assignment = search.best;
+		return search.bestCost;
+	}
+
+private:
+	struct Node
+	{
+		std::vector<int> columns; /*< columns of the first rows */
+		float cost; /*< cost of these rows including their pairs */
+	};
+
+	struct Deque
+	{
+		std::mutex mutex;
+		std::deque<Node> nodes;
+	};
+
+	struct Search
+	{
+		const size_t n;
+		const Objective& objective;
+		std::vector<std::unique_ptr<Deque> > deques;
+		std::atomic<int> pending; /*< nodes pushed but not expanded yet */
+
+		std::mutex bestMutex;
+		std::vector<int> best;
+		float bestCost = std::numeric_limits<float>::infinity(); /*< guarded by bestMutex */
+		std::atomic<float> bound; /*< bestCost for reading without the lock */
+
+		Search(size_t n, const Objective& objective, size_t numOfThreads) :
+			n(n), objective(objective), pending(1), bound(std::numeric_limits<float>::infinity())
+		{
+			for(size_t i = 0; i < numOfThreads; i++)
+				deques.emplace_back(new Deque);
+			deques[0]->nodes.push_back(Node{std::vector<int>(), 0.f});
+		}
+
+		float total(const std::vector<int>& columns) const
+		{
+			float cost = 0.f;
+			for(size_t i = 0; i < n; i++)
+			{
+				cost += objective.linear(i, columns[i]);
+				for(size_t k = i + 1; k < n; k++)
+					cost += objective.pair(i, columns[i], k, columns[k]);
+			}
+			return cost;
+		}
+
+		void offer(const std::vector<int>& columns, float cost)
+		{
+			if(cost >= bound)
+				return;
+			std::lock_guard<std::mutex> lock(bestMutex);
+			if(cost < bestCost)
+			{
+				bestCost = cost;
+				best = columns;
+				bound = cost;
+			}
+		}
+
+		bool take(size_t thread, Node& node)
+		{
+			{
+				Deque& own = *deques[thread];
+				std::lock_guard<std::mutex> lock(own.mutex);
+				if(!own.nodes.empty())
+				{
+					node = std::move(own.nodes.back());
+					own.nodes.pop_back();
+					return true;
+				}
+			}
+			for(size_t i = 1; i < deques.size(); i++)
+			{
+				Deque& other = *deques[(thread + i) % deques.size()];
+				std::lock_guard<std::mutex> lock(other.mutex);
+				if(!other.nodes.empty())
+				{
+					node = std::move(other.nodes.front());
+					other.nodes.pop_front();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		void work(size_t thread)
+		{
+			Node node;
+			while(pending > 0)
+			{
+				if(!take(thread, node))
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				expand(thread, node);
+				pending--;
+			}
+		}
+
+		void expand(size_t thread, const Node& node)
+		{
+			const size_t depth = node.columns.size();
+			if(depth == n)
+			{
+				offer(node.columns, node.cost);
+				return;
+			}
+
+			std::vector<char> used(n, 0);
+			for(int column : node.columns)
+				used[column] = 1;
+			std::vector<int> free;
+			for(size_t j = 0; j < n; j++)
+				if(!used[j])
+					free.push_back((int)j);
+
+			// the remaining rows with their pairs to the assigned ones
+			const size_t m = n - depth;
+			std::vector<float> costs(m * m);
+			for(size_t i = 0; i < m; i++)
+				for(size_t j = 0; j < m; j++)
+				{
+					float cost = objective.linear(depth + i, free[j]);
+					for(size_t k = 0; k < depth; k++)
+						cost += objective.pair(k, node.columns[k], depth + i, free[j]);
+					costs[i * m + j] = cost;
+				}
+
+			std::vector<int> relaxed;
+			std::vector<float> u, v;
+			const float lowerBound = node.cost + HungarianAssignment::solve(m,
+					[&](size_t i, size_t j) { return costs[i * m + j]; }, relaxed, u, v);
+			if(lowerBound >= bound)
+				return;
+
+			std::vector<int> complete = node.columns;
+			for(size_t i = 0; i < m; i++)
+				complete.push_back(free[relaxed[i]]);
+			offer(complete, total(complete));
+
+			// the cheapest child is pushed last to be expanded next
+			std::vector<Node> children;
+			for(size_t j = 0; j < m; j++)
+				if(node.cost + costs[j] < bound)
+				{
+					children.push_back(Node{node.columns, node.cost + costs[j]});
+					children.back().columns.push_back(free[j]);
+				}
+			std::sort(children.begin(), children.end(), [](const Node& a, const Node& b) { return a.cost > b.cost; });
+
+			pending += (int)children.size();
+			Deque& own = *deques[thread];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			for(Node& child : children)
+				own.nodes.push_back(std::move(child));
+		}
+	};
+};
+
+/**
+ * Objective of a linear cost matrix with a penalty for each pair of robots
+ * whose straight paths to their posts cross
+ */
+struct CrossingObjective
+{
+	const std::vector<std::vector<float> >& costs;
+	const std::vector<Vector2f>& from; /*< position of each row */
+	const std::vector<Vector2f>& to; /*< position of each column */
+	float penalty;
+
+	inline float linear(size_t i, size_t j) const { return costs[i][j]; }
+
+	inline float pair(size_t i, size_t j, size_t k, size_t l) const
+	{
+		return crosses(from[i], to[j], from[k], to[l]) ? penalty : 0.f;
+	}
+
+	static bool crosses(const Vector2f& a, const Vector2f& b, const Vector2f& c, const Vector2f& d)
+	{
+		const auto side = [](const Vector2f& p, const Vector2f& q, const Vector2f& r)
+		{
+			return (q.x() - p.x()) * (r.y() - p.y()) - (q.y() - p.y()) * (r.x() - p.x());
+		};
+		return side(a, b, c) * side(a, b, d) < 0.f && side(c, d, a) * side(c, d, b) < 0.f;
+	}
+};
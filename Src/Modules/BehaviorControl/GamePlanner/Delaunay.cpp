@@ -0,0 +1,71 @@
+/**
+ * @file Delaunay.cpp
+ *
+ * Delaunay triangulation of a small set of points (Bowyer-Watson)
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "Delaunay.h"
+#include <algorithm>
+#include <utility>
+
+void Delaunay::triangulate(const std::vector<Vector2f>& points, std::vector<std::array<int, 3> >& triangles)
+{
+	triangles.clear();
+	if(points.size() < 3)
+		return;
+
+	// Bowyer-Watson, the number of points is small so the quadratic version is fine
+	const int n = (int)points.size();
+	std::vector<Vector2f> all = points;
+	all.push_back(Vector2f(-1e5f, -1e5f));
+	all.push_back(Vector2f(1e5f, -1e5f));
+	all.push_back(Vector2f(0.f, 1e5f));
+
+	struct Tri { int v[3]; };
+	std::vector<Tri> tris(1, Tri{{n, n + 1, n + 2}});
+
+	auto inCircumcircle = [&all](const Tri& t, const Vector2f& p)
+	{
+		const double ax = all[t.v[0]].x() - p.x(), ay = all[t.v[0]].y() - p.y();
+		const double bx = all[t.v[1]].x() - p.x(), by = all[t.v[1]].y() - p.y();
+		const double cx = all[t.v[2]].x() - p.x(), cy = all[t.v[2]].y() - p.y();
+		const double det = (ax * ax + ay * ay) * (bx * cy - cx * by) -
+				(bx * bx + by * by) * (ax * cy - cx * ay) +
+				(cx * cx + cy * cy) * (ax * by - bx * ay);
+		const double orientation = (all[t.v[1]].x() - all[t.v[0]].x()) * (all[t.v[2]].y() - all[t.v[0]].y()) -
+				(all[t.v[1]].y() - all[t.v[0]].y()) * (all[t.v[2]].x() - all[t.v[0]].x());
+		return orientation > 0 ? det > 0 : det < 0;
+	};
+
+	for(int i = 0; i < n; i++)
+	{
+		std::vector<std::pair<int, int> > polygon;
+		std::vector<Tri> kept;
+		for(const Tri& t : tris)
+		{
+			if(!inCircumcircle(t, all[i]))
+			{
+				kept.push_back(t);
+				continue;
+			}
+			for(int k = 0; k < 3; k++)
+			{
+				const std::pair<int, int> edge(std::min(t.v[k], t.v[(k + 1) % 3]), std::max(t.v[k], t.v[(k + 1) % 3]));
+				std::vector<std::pair<int, int> >::iterator shared = std::find(polygon.begin(), polygon.end(), edge);
+				if(shared == polygon.end())
+					polygon.push_back(edge);
+				else
+					polygon.erase(shared); // edge between two bad triangles
+			}
+		}
+		for(const std::pair<int, int>& edge : polygon)
+			kept.push_back(Tri{{edge.first, edge.second, i}});
+		tris.swap(kept);
+	}
+
+	for(const Tri& t : tris)
+		if(t.v[0] < n && t.v[1] < n && t.v[2] < n)
+			triangles.push_back(std::array<int, 3>{{t.v[0], t.v[1], t.v[2]}});
+}
@@ -0,0 +1,26 @@
+/**
+ * @file Delaunay.h
+ *
+ * Delaunay triangulation of a small set of points (Bowyer-Watson), used for
+ * the ball anchors of ball-conditioned formations and for the adjacency of
+ * the posts of a formation (the dual of their Voronoi cells).
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Math/Eigen.h"
+#include <array>
+#include <vector>
+
+class Delaunay
+{
+public:
+	/**
+	 * @param points the points, e.g. field coordinates (within ±1e5)
+	 * @param triangles resulting triangles as indices of the points, none if
+	 *        there are less than three points or all of them are collinear
+	 */
+	static void triangulate(const std::vector<Vector2f>& points, std::vector<std::array<int, 3> >& triangles);
+};
@@ -0,0 +1,194 @@
+/**
+ * @file FieldDominanceProvider.cpp
+ *
+ * Computes the field dominance raster, i.e. the earliest arrival time of our
+ * robots for each cell of the field
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "FieldDominanceProvider.h"
+#include "Tools/Debugging/DebugDrawings.h"
+#include "Tools/Debugging/Stopwatch.h"
+#include <algorithm>
+
+MAKE_MODULE(FieldDominanceProvider, behaviorControl)
+
+/**
+ * acos with an absolute error below 7e-5 (Abramowitz & Stegun 4.4.45)
+ */
+static inline float approxAcos(float x)
+{
+	const float a = std::min(std::abs(x), 1.f);
+	const float r = std::sqrt(1.f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f - 0.0187293f * a)));
+	return x < 0.f ? pi - r : r;
+}
+
+void FieldDominanceProvider::update(FieldDominance& fieldDominance)
+{
+	DECLARE_DEBUG_DRAWING("module:FieldDominanceProvider", "drawingOnField");
+
+	if(!fieldDominance.width || fieldDominance.cellSize != cellSize)
+		init(fieldDominance);
+
+	dirtyBegin = fieldDominance.height;
+	dirtyEnd = 0;
+
+	STOPWATCH("FieldDominanceProvider:updateRobots")
+	{
+		for(RobotRaster& robot : robots)
+			robot.seen = false;
+
+		updateRobot(theRobotInfo.number, theRobotPose, fieldDominance);
+		for(auto& teammate : theTeammateData.teammates)
+			if(teammate.status == Teammate::PLAYING)
+				updateRobot(teammate.number, teammate.pose, fieldDominance);
+
+		// robots that are gone (penalized, fallen, ...) release their cells
+		for(std::vector<RobotRaster>::iterator robot = robots.begin(); robot != robots.end();)
+		{
+			if(robot->seen)
+				++robot;
+			else
+			{
+				markRows(robot->pose.translation.y(), fieldDominance);
+				robot = robots.erase(robot);
+			}
+		}
+	}
+
+	// combine the rasters of the robots in the changed rows
+	const int width = fieldDominance.width;
+	for(int row = dirtyBegin; row < dirtyEnd; row++)
+	{
+		float* time = fieldDominance.arrivalTime.data() + row * width;
+		signed char* fastest = fieldDominance.fastestRobot.data() + row * width;
+		std::fill(time, time + width, timeHorizon);
+		std::fill(fastest, fastest + width, (signed char)-1);
+
+		for(const RobotRaster& robot : robots)
+		{
+			const float* robotTime = robot.time.data() + row * width;
+			const signed char number = (signed char)robot.number;
+			for(int c = 0; c < width; c++)
+			{
+				const bool earlier = robotTime[c] < time[c];
+				time[c] = earlier ? robotTime[c] : time[c];
+				fastest[c] = earlier ? number : fastest[c];
+			}
+		}
+	}
+
+	draw(fieldDominance);
+}
+
+void FieldDominanceProvider::init(FieldDominance& fieldDominance)
+{
+	fieldDominance.cellSize = cellSize;
+	fieldDominance.origin = Vector2f(theFieldDimensions.xPosOwnFieldBorder, theFieldDimensions.yPosRightFieldBorder);
+	fieldDominance.width = (int)std::ceil((theFieldDimensions.xPosOpponentFieldBorder -
+			theFieldDimensions.xPosOwnFieldBorder) / cellSize);
+	fieldDominance.height = (int)std::ceil((theFieldDimensions.yPosLeftFieldBorder -
+			theFieldDimensions.yPosRightFieldBorder) / cellSize);
+	fieldDominance.arrivalTime.assign(fieldDominance.width * fieldDominance.height, timeHorizon);
+	fieldDominance.fastestRobot.assign(fieldDominance.width * fieldDominance.height, -1);
+	robots.clear();
+
+	// inverse of the rest to rest profile: triangle below 2 * maxV / maxA, trapezoid above
+	reach = timeHorizon >= 2.f * maxV / maxA ?
+			(timeHorizon - maxV / maxA) * maxV : maxA * timeHorizon * timeHorizon / 4.f;
+}
+
+void FieldDominanceProvider::updateRobot(int number, const Pose2f& pose, FieldDominance& fieldDominance)
+{
+	const auto rowOf = [&fieldDominance](float y)
+	{
+		return (int)std::floor((y - fieldDominance.origin.y()) / fieldDominance.cellSize);
+	};
+
+	std::vector<RobotRaster>::iterator robot = std::find_if(robots.begin(), robots.end(),
+			[number](const RobotRaster& r) { return r.number == number; });
+
+	float yMin = pose.translation.y(), yMax = pose.translation.y();
+	if(robot == robots.end())
+	{
+		robots.push_back(RobotRaster{number, pose, true,
+				std::vector<float>(fieldDominance.arrivalTime.size(), timeHorizon)});
+		robot = robots.end() - 1;
+	}
+	else
+	{
+		robot->seen = true;
+		if((pose.translation - robot->pose.translation).norm() < moveThreshold &&
+				std::abs(Angle::normalize(pose.rotation - robot->pose.rotation)) < turnThreshold)
+			return;
+
+		yMin = std::min(yMin, robot->pose.translation.y());
+		yMax = std::max(yMax, robot->pose.translation.y());
+		robot->pose = pose;
+	}
+
+	const int begin = std::max(0, rowOf(yMin - reach));
+	const int end = std::min(fieldDominance.height, rowOf(yMax + reach) + 1);
+	computeRows(*robot, begin, end, fieldDominance);
+	dirtyBegin = std::min(dirtyBegin, begin);
+	dirtyEnd = std::max(dirtyEnd, end);
+}
+
+void FieldDominanceProvider::computeRows(RobotRaster& robot, int begin, int end, const FieldDominance& fieldDominance)
+{
+	const int width = fieldDominance.width;
+	const float cell = fieldDominance.cellSize;
+	const float x0 = fieldDominance.origin.x() + cell / 2.f - robot.pose.translation.x();
+	const float hx = std::cos(robot.pose.rotation), hy = std::sin(robot.pose.rotation);
+
+	for(int row = begin; row < end; row++)
+	{
+		const float dy = fieldDominance.origin.y() + (row + 0.5f) * cell - robot.pose.translation.y();
+		float* time = robot.time.data() + row * width;
+		for(int c = 0; c < width; c++)
+		{
+			const float dx = x0 + c * cell;
+			const float d = std::sqrt(dx * dx + dy * dy);
+			const float angle = approxAcos((dx * hx + dy * hy) / std::max(d, 1.f));
+			time[c] = std::min(restToRestTime(d, maxA, maxV) + restToRestTime(angle, maxRotA, maxRotV), timeHorizon);
+		}
+	}
+}
+
+void FieldDominanceProvider::markRows(float y, const FieldDominance& fieldDominance)
+{
+	const int begin = (int)std::floor((y - reach - fieldDominance.origin.y()) / fieldDominance.cellSize);
+	const int end = (int)std::floor((y + reach - fieldDominance.origin.y()) / fieldDominance.cellSize) + 1;
+	dirtyBegin = std::min(dirtyBegin, std::max(0, begin));
+	dirtyEnd = std::max(dirtyEnd, std::min(fieldDominance.height, end));
+}
+
+void FieldDominanceProvider::draw(const FieldDominance& fieldDominance) const
+{
+	COMPLEX_DRAWING("module:FieldDominanceProvider")
+	{
+		static const ColorRGBA colors[] =
+		{
+			ColorRGBA::gray, ColorRGBA::red, ColorRGBA::blue, ColorRGBA::yellow, ColorRGBA::magenta, ColorRGBA::cyan, ColorRGBA::orange
+		};
+
+		// every third cell is enough for a picture of the field
+		const float cell = fieldDominance.cellSize;
+		for(int row = 0; row < fieldDominance.height; row += 3)
+			for(int c = 0; c < fieldDominance.width; c += 3)
+			{
+				const int i = row * fieldDominance.width + c;
+				const int number = fieldDominance.fastestRobot[i];
+				if(number < 0)
+					continue;
+
+				ColorRGBA color = colors[number % 7];
+				color.a = (unsigned char)(200.f * (1.f - fieldDominance.arrivalTime[i] / timeHorizon));
+				FILLED_RECTANGLE("module:FieldDominanceProvider",
+						fieldDominance.origin.x() + c * cell, fieldDominance.origin.y() + row * cell,
+						fieldDominance.origin.x() + (c + 3) * cell, fieldDominance.origin.y() + (row + 3) * cell,
+						0, Drawings::noPen, color, Drawings::solidBrush, color);
+			}
+	}
+}
@@ -0,0 +1,53 @@
+/**
+ * @file FormationAdjacency.h
+ *
+ * Which posts of a formation are neighbors, i.e. whose Voronoi cells share an
+ * edge. That is the Delaunay triangulation of the posts. A formation of less
+ * than three posts or with all posts on a line has all pairs adjacent.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Delaunay.h"
+#include <array>
+#include <vector>
+
+class FormationAdjacency
+{
+public:
+	FormationAdjacency() = default;
+
+	explicit FormationAdjacency(const std::vector<Vector2f>& posts) :
+		n(posts.size()), matrix(posts.size() * posts.size(), 0), neighbors_(posts.size())
+	{
+		std::vector<std::array<int, 3> > triangles;
+		Delaunay::triangulate(posts, triangles);
+		for(const std::array<int, 3>& t : triangles)
+			for(int k = 0; k < 3; k++)
+				connect(t[k], t[(k + 1) % 3]);
+		if(triangles.empty())
+			for(size_t a = 0; a < n; a++)
+				for(size_t b = a + 1; b < n; b++)
+					connect((int)a, (int)b);
+	}
+
+	inline bool adjacent(int a, int b) const { return matrix[a * n + b] != 0; }
+	inline const std::vector<int>& neighbors(int post) const { return neighbors_[post]; }
+	inline size_t size() const { return n; }
+
+private:
+	void connect(int a, int b)
+	{
+		if(adjacent(a, b))
+			return;
+		matrix[a * n + b] = matrix[b * n + a] = 1;
+		neighbors_[a].push_back(b);
+		neighbors_[b].push_back(a);
+	}
+
+	size_t n = 0;
+	std::vector<char> matrix; /*< matrix[a * n + b] */
+	std::vector<std::vector<int> > neighbors_; /*< adjacent posts of each post */
+};
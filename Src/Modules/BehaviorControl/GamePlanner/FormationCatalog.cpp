@@ -0,0 +1,181 @@
+/**
+ * @file FormationCatalog.cpp
+ *
+ * All formations of the Config/Formations directory and a watcher rereading them
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "FormationCatalog.h"
+#include "Representations/BehaviorControl/AgentTask.h"
+#include <dirent.h>
+#include <iostream>
+#include <mutex>
+#ifdef LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+/**
+ * One instance per path for the whole process, alive as long as anyone holds it
+ */
+template<typename T> static std::shared_ptr<T> sharedInstance(const std::string& path)
+{
+	static std::mutex mutex;
+	static std::map<std::string, std::weak_ptr<T> > instances;
+
+	// others asking for the same path meanwhile wait instead of reading it as well
+	std::lock_guard<std::mutex> lock(mutex);
+	std::shared_ptr<T> instance = instances[path].lock();
+	if(!instance)
+	{
+		instance = std::make_shared<T>(path);
+		instances[path] = instance;
+	}
+	return instance;
+}
+
+FormationCatalog::FormationCatalog(const std::string& path)
+{
+	read(path, "");
+}
+
+std::shared_ptr<const FormationCatalog> FormationCatalog::shared(const std::string& path)
+{
+	return sharedInstance<const FormationCatalog>(path);
+}
+
+const std::vector<VoronoiCell>* FormationCatalog::formation(const std::string& name) const
+{
+	const auto i = formations.find(name);
+	return i != formations.end() ? &i->second : nullptr;
+}
+
+const BallConditionedFormation* FormationCatalog::ballFormation(const std::string& name) const
+{
+	const auto i = ballConditionedFormations.find(name);
+	return i != ballConditionedFormations.end() ? &i->second : nullptr;
+}
+
+const FormationAdjacency* FormationCatalog::adjacency(const std::string& name) const
+{
+	const auto i = adjacencies.find(name);
+	return i != adjacencies.end() ? &i->second : nullptr;
+}
+
+void FormationCatalog::read(const std::string& path, const std::string& prefix)
+{
+	DIR* dir = opendir(path.c_str());
+	if(!dir)
+	{
+		perror("could not open directory");
+		return;
+	}
+	_directories.push_back(path);
+
+	const auto hasSuffix = [](const std::string& name, const std::string& suffix)
+	{
+		return name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+	};
+
+	std::vector<std::string> subdirectories;
+	AgentTask reader;
+	while(struct dirent* ent = readdir(dir))
+	{
+		const std::string name(ent->d_name);
+		if(name.empty() || name[0] == '.')
+			continue;
+
+		if(hasSuffix(name, ".cfg"))
+		{
+			std::vector<VoronoiCell>& tiles = formations[prefix + name];
+			reader.getTilesFromFile(path + name, tiles);
+
+			// ball-conditioned data lives next to the formation file
+			BallConditionedFormation ballFormation;
+			if(ballFormation.load(path + name.substr(0, name.size() - 4) + ".sbsp", (unsigned)tiles.size()))
+				ballConditionedFormations[prefix + name] = ballFormation;
+
+			std::vector<Vector2f> posts;
+			for(const VoronoiCell& tile : tiles)
+				posts.push_back(tile.globalPose().translation);
+			adjacencies[prefix + name] = FormationAdjacency(posts);
+		}
+		else if(name.find('.') == std::string::npos)
+			subdirectories.push_back(name);
+	}
+	closedir(dir);
+
+	// entries without an extension might be directories, opendir tells
+	for(const std::string& subdirectory : subdirectories)
+	{
+		DIR* sub = opendir((path + subdirectory).c_str());
+		if(sub)
+		{
+			closedir(sub);
+			read(path + subdirectory + "/", prefix + subdirectory + "/");
+		}
+	}
+}
+
+FormationWatcher::FormationWatcher(const std::string& path) :
+	path(path), latest(std::make_shared<FormationCatalog>(path)), stop(false)
+{
+#ifdef LINUX
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(inotifyFd < 0)
+		std::cerr << "could not watch " << path << ", formations are not reloaded" << std::endl;
+	else
+	{
+		for(const std::string& directory : latest->directories())
+			inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_CREATE);
+		thread = std::thread(&FormationWatcher::run, this);
+	}
+#endif
+}
+
+std::shared_ptr<FormationWatcher> FormationWatcher::shared(const std::string& path)
+{
+	return sharedInstance<FormationWatcher>(path);
+}
+
+FormationWatcher::~FormationWatcher()
+{
+	stop = true;
+	if(thread.joinable())
+		thread.join();
+#ifdef LINUX
+	if(inotifyFd >= 0)
+		close(inotifyFd);
+#endif
+}
+
+void FormationWatcher::run()
+{
+#ifdef LINUX
+	alignas(struct inotify_event) char events[4096];
+	pollfd request = {inotifyFd, POLLIN, 0};
+	while(!stop)
+	{
+		if(poll(&request, 1, 200) <= 0)
+			continue;
+
+		// an editor saving a formation causes several events, wait until it is done
+		do
+			while(read(inotifyFd, events, sizeof(events)) > 0);
+		while(!stop && poll(&request, 1, 100) > 0);
+		if(stop)
+			break;
+
+		const std::shared_ptr<const FormationCatalog> catalog = std::make_shared<FormationCatalog>(path);
+
+		// new subdirectories are watched as well, existing watches are just updated
+		for(const std::string& directory : catalog->directories())
+			inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_CREATE);
+
+		std::atomic_store(&latest, catalog);
+		std::cerr << "reloaded formations from " << path << std::endl;
+	}
+#endif
+}
@@ -0,0 +1,107 @@
+/**
+ * @file FormationCatalog.h
+ *
+ * All formations of the Config/Formations directory and its subdirectories,
+ * immutable once read, and a watcher that rereads them when they change.
+ *
+ * The watcher parses changed files on its own thread into a new catalog and
+ * publishes it by swapping a shared pointer atomically. The module picks up
+ * the latest catalog at the beginning of a frame, so a frame never sees a
+ * partially read catalog and never waits for the parser. An old catalog is
+ * freed when the last module holding it has switched to the new one.
+ *
+ * In SimRobot all robots run in one process, so the catalog and the watcher
+ * of a directory are shared by all modules instead of being read per robot.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/VoronoiCell.h"
+#include "BallConditionedFormation.h"
+#include "FormationAdjacency.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class FormationCatalog
+{
+public:
+	/**
+	 * Reads all formations (*.cfg) and their ball-conditioned data (*.sbsp)
+	 * @param path directory of the formations, files in subdirectories are named "subdirectory/file.cfg"
+	 */
+	explicit FormationCatalog(const std::string& path);
+
+	/**
+	 * The catalog of a directory shared by all modules of the process, it is
+	 * only read if no module holds it yet
+	 */
+	static std::shared_ptr<const FormationCatalog> shared(const std::string& path);
+
+	/**
+	 * @return the posts of a formation, nullptr if there is none of that name
+	 */
+	const std::vector<VoronoiCell>* formation(const std::string& name) const;
+
+	/**
+	 * @return the ball-conditioned data of a formation, nullptr if it has none
+	 */
+	const BallConditionedFormation* ballFormation(const std::string& name) const;
+
+	/**
+	 * @return which posts of a formation are neighbors, nullptr if there is no formation of that name
+	 */
+	const FormationAdjacency* adjacency(const std::string& name) const;
+
+	/**
+	 * The directory and all subdirectories that were read
+	 */
+	inline const std::vector<std::string>& directories() const { return _directories; }
+
+private:
+	void read(const std::string& path, const std::string& prefix);
+
+	std::map<std::string, std::vector<VoronoiCell> > formations;
+	std::map<std::string, BallConditionedFormation> ballConditionedFormations;
+	std::map<std::string, FormationAdjacency> adjacencies; /*< of the posts of each formation */
+	std::vector<std::string> _directories;
+};
+
+class FormationWatcher
+{
+public:
+	/**
+	 * Reads the catalog and starts watching its directories (only on Linux,
+	 * elsewhere the catalog read first is kept)
+	 */
+	explicit FormationWatcher(const std::string& path);
+	~FormationWatcher();
+
+	/**
+	 * The watcher of a directory shared by all modules of the process, it is
+	 * only started if no module holds it yet
+	 */
+	static std::shared_ptr<FormationWatcher> shared(const std::string& path);
+
+	FormationWatcher(const FormationWatcher&) = delete;
+	FormationWatcher& operator=(const FormationWatcher&) = delete;
+
+	/**
+	 * The catalog read last
+	 */
+	inline std::shared_ptr<const FormationCatalog> catalog() const { return std::atomic_load(&latest); }
+
+private:
+	void run();
+
+	std::string path;
+	std::shared_ptr<const FormationCatalog> latest; /*< only accessed atomically */
+	std::atomic<bool> stop;
+	int inotifyFd = -1;
+	std::thread thread;
+};
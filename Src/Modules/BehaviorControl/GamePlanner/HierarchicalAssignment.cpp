@@ -0,0 +1,119 @@
+/**
+ * @file HierarchicalAssignment.cpp
+ *
+ * Approximate assignment of many agents to posts grouped into lines
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "HierarchicalAssignment.h"
+#include "Tools/HungarianAssignment.h"
+#include <algorithm>
+#include <limits>
+
+float HierarchicalAssignment::solve(const std::vector<std::vector<float> >& costs, const std::vector<int>& lineOfPost,
+		int numOfLines, ThreadPool* pool, std::vector<int>& assignment)
+{
+	const size_t n = costs.size();
+	std::vector<std::vector<int> > postsOfLine(numOfLines);
+	for(size_t j = 0; j < n; j++)
+		postsOfLine[lineOfPost[j]].push_back((int)j);
+
+	// mean cost of each agent to each line
+	std::vector<std::vector<float> > lineCosts(n, std::vector<float>(numOfLines, 0.f));
+	for(size_t i = 0; i < n; i++)
+		for(int l = 0; l < numOfLines; l++)
+		{
+			for(int j : postsOfLine[l])
+				lineCosts[i][l] += costs[i][j];
+			if(!postsOfLine[l].empty())
+				lineCosts[i][l] /= (float)postsOfLine[l].size();
+		}
+
+	// distribute the agents to the lines, each with as many places as posts, by
+	// successive shortest paths: every agent enters the line that is cheapest for
+	// the team, possibly pushing agents of full lines on to other lines
+	std::vector<std::vector<int> > agentsOfLine(numOfLines);
+	std::vector<size_t> freePlaces(numOfLines);
+	for(int l = 0; l < numOfLines; l++)
+		freePlaces[l] = postsOfLine[l].size();
+	std::vector<float> distance(numOfLines);
+	std::vector<int> previous(numOfLines), mover(numOfLines);
+	std::vector<std::vector<float> > moveCost(numOfLines, std::vector<float>(numOfLines));
+	std::vector<std::vector<int> > moveAgent(numOfLines, std::vector<int>(numOfLines));
+	for(size_t k = 0; k < n; k++)
+	{
+		// cheapest agent to push from one line to another
+		for(int l = 0; l < numOfLines; l++)
+			for(int m = 0; m < numOfLines; m++)
+			{
+				moveCost[l][m] = std::numeric_limits<float>::infinity();
+				moveAgent[l][m] = -1;
+				if(l != m)
+					for(int i : agentsOfLine[l])
+						if(lineCosts[i][m] - lineCosts[i][l] < moveCost[l][m])
+						{
+							moveCost[l][m] = lineCosts[i][m] - lineCosts[i][l];
+							moveAgent[l][m] = i;
+						}
+			}
+
+		// Bellman-Ford over the lines, there is no negative cycle since the agents placed so far are distributed optimally
+		for(int l = 0; l < numOfLines; l++)
+		{
+			distance[l] = lineCosts[k][l];
+			previous[l] = -1;
+		}
+		for(int round = 1; round < numOfLines; round++)
+			for(int l = 0; l < numOfLines; l++)
+				for(int m = 0; m < numOfLines; m++)
+					if(moveAgent[l][m] >= 0 && distance[l] + moveCost[l][m] < distance[m])
+					{
+						distance[m] = distance[l] + moveCost[l][m];
+						previous[m] = l;
+						mover[m] = moveAgent[l][m];
+					}
+
+		int sink = -1;
+		for(int l = 0; l < numOfLines; l++)
+			if(freePlaces[l] && (sink < 0 || distance[l] < distance[sink]))
+				sink = l;
+		freePlaces[sink]--;
+
+		// every agent on the path moves on by one line, the new one enters the first
+		int line = sink;
+		while(previous[line] >= 0)
+		{
+			std::vector<int>& from = agentsOfLine[previous[line]];
+			from.erase(std::find(from.begin(), from.end(), mover[line]));
+			agentsOfLine[line].push_back(mover[line]);
+			line = previous[line];
+		}
+		agentsOfLine[line].push_back((int)k);
+	}
+
+	// the lines are independent of each other now
+	assignment.resize(n);
+	const auto solveLine = [&](size_t l)
+	{
+		const std::vector<int>& agents = agentsOfLine[l];
+		const std::vector<int>& posts = postsOfLine[l];
+		std::vector<int> postOfAgent;
+		std::vector<float> lineU, lineV;
+		HungarianAssignment::solve(agents.size(),
+				[&](size_t i, size_t j) { return costs[agents[i]][posts[j]]; }, postOfAgent, lineU, lineV);
+		for(size_t i = 0; i < agents.size(); i++)
+			assignment[agents[i]] = posts[postOfAgent[i]];
+	};
+	// without workers the pool only adds the cost of handing out the lines
+	if(pool && pool->size())
+		pool->parallelFor(numOfLines, solveLine);
+	else
+		for(int l = 0; l < numOfLines; l++)
+			solveLine(l);
+
+	float total = 0.f;
+	for(size_t i = 0; i < n; i++)
+		total += costs[i][assignment[i]];
+	return total;
+}
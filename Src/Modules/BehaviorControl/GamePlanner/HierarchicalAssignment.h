@@ -0,0 +1,55 @@
+/**
+ * @file HierarchicalAssignment.h
+ *
+ * Approximate assignment of many agents to posts grouped into lines (defence,
+ * midfield, attack), meant for large simulated teams.
+ *
+ * First the agents are distributed to the lines, which is a transportation
+ * problem: each line takes as many agents as it has posts and an agent costs
+ * its mean cost to the posts of the line. It is solved by successive shortest
+ * paths over the lines: every agent enters the line that is cheapest for the
+ * team, pushing agents of full lines on along the cheapest moves. With L lines
+ * this takes O(n² L²) instead of the O(n³) of an assignment over all posts.
+ * Then the agents of each line are assigned to its posts, which costs the sum
+ * of the cubes of the line sizes, about n³ / 9 for three even lines. The
+ * lines are independent and are handed to the workers of the thread pool if
+ * it has any.
+ *
+ * The result is optimal within each line but not across lines, there are no
+ * dual potentials to certify it.
+ *
+ * Util/HierarchicalBenchmark measured on a single core (three even lines,
+ * walking times on straight lines, 200 runs):
+ *
+ *   agents  exact µs  hierarchical µs  mean / max extra cost
+ *       11       3.0              4.6        5.1% / 42.8%
+ *       22      12.3             11.5        4.1% / 25.5%
+ *       44      49.5             34.4        3.5% / 22.8%
+ *       88     218.3            104.2        2.5% / 17.5%
+ *      176    1143.2            426.5        1.6% / 14.2%
+ *
+ * So it only pays off from about 22 agents on, never for the five of a
+ * standard team.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/ThreadPool.h"
+#include <vector>
+
+class HierarchicalAssignment
+{
+public:
+	/**
+	 * @param costs square matrix of the costs of each agent to each post
+	 * @param lineOfPost line of each post, 0 .. numOfLines - 1
+	 * @param numOfLines number of lines
+	 * @param pool threads to solve the lines on, nullptr to solve them one after another
+	 * @param assignment resulting post of each agent
+	 * @return the total cost of the assignment
+	 */
+	static float solve(const std::vector<std::vector<float> >& costs, const std::vector<int>& lineOfPost,
+			int numOfLines, ThreadPool* pool, std::vector<int>& assignment);
+};
@@ -0,0 +1,111 @@
+/**
+ * @file LatticeCostTable.cpp
+ *
+ * Cost-to-go table of a state lattice of walk primitives
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "LatticeCostTable.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#ifndef WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LatticeCostTable::~LatticeCostTable()
+{
+	unload();
+}
+
+void LatticeCostTable::unload()
+{
+#ifndef WINDOWS
+	if(mapping)
+		munmap(mapping, mappingSize);
+#endif
+	mapping = nullptr;
+	mappingSize = 0;
+	values = nullptr;
+	buffer.clear();
+}
+
+bool LatticeCostTable::load(const std::string& file)
+{
+	unload();
+
+	size_t size = 0;
+	const char* data = nullptr;
+#ifndef WINDOWS
+	const int fd = open(file.c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+	struct stat status;
+	if(fstat(fd, &status) == 0 && status.st_size >= (off_t)sizeof(Header))
+	{
+		mappingSize = (size_t)status.st_size;
+		mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mapping == MAP_FAILED)
+			mapping = nullptr;
+	}
+	close(fd);
+	if(!mapping)
+		return false;
+	size = mappingSize;
+	data = static_cast<const char*>(mapping);
+#else
+	FILE* stream = fopen(file.c_str(), "rb");
+	if(!stream)
+		return false;
+	fseek(stream, 0, SEEK_END);
+	size = (size_t)ftell(stream);
+	fseek(stream, 0, SEEK_SET);
+	buffer.resize((size + 1) / 2);
+	size = fread(buffer.data(), 1, size, stream);
+	fclose(stream);
+	data = reinterpret_cast<const char*>(buffer.data());
+#endif
+
+	if(size < sizeof(Header))
+	{
+		unload();
+		return false;
+	}
+	std::memcpy(&header, data, sizeof(Header));
+	const size_t numOfValues = (size_t)header.cellsX * header.cellsY * header.numOfAngles;
+	if(std::strncmp(header.magic, "LTC1", 4) || header.cellsX <= 1 || header.cellsY <= 1 ||
+			header.numOfAngles <= 0 || size < sizeof(Header) + numOfValues * sizeof(uint16_t))
+	{
+		unload();
+		return false;
+	}
+
+	values = reinterpret_cast<const uint16_t*>(data + sizeof(Header));
+	return true;
+}
+
+float LatticeCostTable::operator()(const Pose2f& robot, const Pose2f& goal) const
+{
+	// the robot in the frame of the goal
+	const Pose2f relative = goal.inverse() * robot;
+
+	const float fx = relative.translation.x() / header.cellSize + header.cellsX / 2;
+	const float fy = relative.translation.y() / header.cellSize + header.cellsY / 2;
+	if(fx < 0.f || fy < 0.f || fx >= header.cellsX - 1 || fy >= header.cellsY - 1)
+		return -1.f;
+
+	const float angleStep = 2.f * pi / header.numOfAngles;
+	const int a = ((int)std::floor(relative.rotation / angleStep + 0.5f) % header.numOfAngles + header.numOfAngles) %
+			header.numOfAngles;
+
+	const int x = (int)fx, y = (int)fy;
+	const float tx = fx - x, ty = fy - y;
+	const uint16_t* v = values + ((size_t)a * header.cellsY + y) * header.cellsX + x;
+	const float low = v[0] + tx * (v[1] - v[0]);
+	const float high = v[header.cellsX] + tx * (v[header.cellsX + 1] - v[header.cellsX]);
+	return (low + ty * (high - low)) * header.scale;
+}
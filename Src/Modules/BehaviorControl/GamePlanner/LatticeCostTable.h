@@ -0,0 +1,68 @@
+/**
+ * @file LatticeCostTable.h
+ *
+ * Cost-to-go table of a state lattice of walk primitives, generated offline
+ * with Util/LatticeGenerator
+ *
+ * The table holds the time to reach a goal pose from every pose relative to
+ * it (x, y, rotation), quantized to 16 bit. It is mapped into memory at
+ * startup, so a lookup is a transformation into the goal frame, a bilinear
+ * interpolation over x and y and the nearest heading.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Math/Pose2f.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class LatticeCostTable
+{
+public:
+	LatticeCostTable() = default;
+	LatticeCostTable(const LatticeCostTable&) = delete;
+	LatticeCostTable& operator=(const LatticeCostTable&) = delete;
+	~LatticeCostTable();
+
+	/**
+	 * Maps the table file into memory
+	 * @return false if the file doesn't exist or is inconsistent
+	 */
+	bool load(const std::string& file);
+
+	inline bool empty() const { return !values; }
+
+	/**
+	 * Time to walk from a pose to a goal pose
+	 * @return the time, negative if the relative pose is outside of the table
+	 */
+	float operator()(const Pose2f& robot, const Pose2f& goal) const;
+
+	/**
+	 * Forward speed the table was generated for, i.e. time * forwardV() is the
+	 * length of a straight walk that takes as long
+	 */
+	inline float forwardV() const { return header.forwardV; }
+
+private:
+	// layout of the file, must match Util/LatticeGenerator
+	struct Header
+	{
+		char magic[4]; /*< "LTC1" */
+		int32_t cellsX, cellsY, numOfAngles;
+		float cellSize; /*< mm */
+		float scale; /*< seconds per unit of the stored values */
+		float forwardV; /*< forward speed the table was generated for (mm/s) */
+	};
+
+	void unload();
+
+	Header header;
+	const uint16_t* values = nullptr; /*< heading major, then y, then x */
+	void* mapping = nullptr; /*< whole file as mapped */
+	size_t mappingSize = 0;
+	std::vector<uint16_t> buffer; /*< file contents where there is no mmap */
+};
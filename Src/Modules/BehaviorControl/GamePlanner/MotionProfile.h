@@ -0,0 +1,115 @@
+/**
+ * @file MotionProfile.h
+ *
+ * Acceleration and velocity limits of the robots as used by the timeCost
+ * motion model, per player number. The values are estimated offline from
+ * odometry logs with Util/MotionProfileFitter and loaded from
+ * motionProfiles.cfg. Robots without an entry use the default profile.
+ *
+ * The walk is omnidirectional: the robot translates and turns at the same
+ * time, and like the speed requests of the walk, the speeds relative to the
+ * limits are bounded by a unit ellipsoid. The limits for translating in a
+ * direction come from the ellipse through the forward and sideways limits.
+ * For a straight walk turning at a constant rate, the ellipsoid gives
+ * T = sqrt(Tt² + Tr²), where Tt and Tr are the times of translating and
+ * turning alone.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Streams/Streamable.h"
+#include "Tools/Math/Eigen.h"
+#include "Tools/TimeCostTable.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+class MotionLimits : public Streamable
+{
+public:
+	MotionLimits() = default;
+	MotionLimits(float maxA, float maxV) : maxA(maxA), maxV(maxV) {}
+
+	float maxA = 1.f; /*< acceleration limit (mm/s² or rad/s²) */
+	float maxV = 1.f; /*< velocity limit (mm/s or rad/s) */
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(maxA);
+		STREAM(maxV);
+		STREAM_REGISTER_FINISH;
+	}
+};
+
+class MotionProfile : public Streamable
+{
+public:
+	int number = 0; /*< player number the profile belongs to */
+	std::string name; /*< name of the robot the profile was fitted for */
+	MotionLimits forward = MotionLimits(16.f, 220.f);
+	MotionLimits sideways = MotionLimits(16.f, 220.f);
+	MotionLimits turning = MotionLimits(0.2f, 0.25f);
+
+	/**
+	 * Time to reach a pose relative to the robot
+	 * @param table the interpolated timeCost
+	 * @param target translation of the pose relative to the robot
+	 * @param rotation rotation of the pose relative to the robot
+	 * @param v0 current translational speed
+	 */
+	inline float timeToPose(const TimeCostTable& table, const Vector2f& target, float rotation, float v0 = 0.f) const
+	{
+		const float d = target.norm();
+		const float c = d > 0.f ? target.x() / d : 1.f, s = d > 0.f ? target.y() / d : 0.f;
+		const float maxA = forward.maxA * sideways.maxA /
+				std::sqrt(sqr(sideways.maxA * c) + sqr(forward.maxA * s));
+		const float maxV = forward.maxV * sideways.maxV /
+				std::sqrt(sqr(sideways.maxV * c) + sqr(forward.maxV * s));
+		const float translationTime = table(d, v0, maxA, maxV);
+		const float rotationTime = table(rotation, turning.maxA, turning.maxV);
+		return std::sqrt(sqr(translationTime) + sqr(rotationTime));
+	}
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(number);
+		STREAM(name);
+		STREAM(forward);
+		STREAM(sideways);
+		STREAM(turning);
+		STREAM_REGISTER_FINISH;
+	}
+};
+
+class MotionProfiles : public Streamable
+{
+public:
+	MotionProfile defaultProfile; /*< used for robots without an entry */
+	std::vector<MotionProfile> robots;
+
+	/**
+	 * Profile of a player, the default one if there is none
+	 */
+	const MotionProfile& forPlayer(int number) const
+	{
+		for(const MotionProfile& profile : robots)
+			if(profile.number == number)
+				return profile;
+		return defaultProfile;
+	}
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(defaultProfile);
+		STREAM(robots);
+		STREAM_REGISTER_FINISH;
+	}
+};
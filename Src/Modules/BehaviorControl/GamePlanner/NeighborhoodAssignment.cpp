@@ -0,0 +1,83 @@
+/**
+ * @file NeighborhoodAssignment.cpp
+ *
+ * Local search on an assignment of agents to posts along adjacent posts
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "NeighborhoodAssignment.h"
+
+float NeighborhoodAssignment::improve(const std::vector<std::vector<float> >& costs,
+		const FormationAdjacency& adjacency, unsigned maxCycle, int locked, std::vector<int>& assignment)
+{
+	const size_t n = assignment.size();
+	Search search(costs, adjacency, maxCycle, n);
+
+	// every move reduces the cost, the bound only guards against rounding
+	for(size_t iteration = 0; iteration < n * n; iteration++)
+	{
+		std::fill(search.agentOf.begin(), search.agentOf.end(), -1);
+		for(size_t i = 0; i < n; i++)
+			if((int)i != locked)
+				search.agentOf[assignment[i]] = (int)i;
+
+		search.bestDelta = -1e-4f;
+		search.bestCycle.clear();
+		for(size_t start = 0; start < n; start++)
+			if(search.agentOf[start] >= 0)
+			{
+				search.path.assign(1, (int)start);
+				search.onPath[start] = 1;
+				search.extend();
+				search.onPath[start] = 0;
+			}
+		if(search.bestCycle.empty())
+			break;
+
+		const std::vector<int>& cycle = search.bestCycle;
+		for(size_t k = 0; k < cycle.size(); k++)
+			assignment[search.agentOf[cycle[k]]] = cycle[(k + 1) % cycle.size()];
+	}
+
+	float total = 0.f;
+	for(size_t i = 0; i < n; i++)
+		total += costs[i][assignment[i]];
+	return total;
+}
+
+void NeighborhoodAssignment::Search::extend()
+{
+	const int first = path.front();
+	for(int next : adjacency.neighbors(path.back()))
+	{
+		if(next < first || onPath[next] || agentOf[next] < 0)
+			continue;
+		path.push_back(next);
+		onPath[next] = 1;
+
+		// a swap needs only the edge, longer cycles have to close to the first post
+		if(path.size() == 2 || adjacency.adjacent(next, first))
+			evaluate();
+		if(path.size() < maxCycle)
+			extend();
+
+		onPath[next] = 0;
+		path.pop_back();
+	}
+}
+
+void NeighborhoodAssignment::Search::evaluate()
+{
+	float delta = 0.f;
+	for(size_t k = 0; k < path.size(); k++)
+	{
+		const int agent = agentOf[path[k]];
+		delta += costs[agent][path[(k + 1) % path.size()]] - costs[agent][path[k]];
+	}
+	if(delta < bestDelta)
+	{
+		bestDelta = delta;
+		bestCycle = path;
+	}
+}
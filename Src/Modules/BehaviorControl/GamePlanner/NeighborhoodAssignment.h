@@ -0,0 +1,64 @@
+/**
+ * @file NeighborhoodAssignment.h
+ *
+ * Local search on an assignment of agents to posts that only moves agents to
+ * adjacent posts: swaps of two agents on neighboring posts and rotations of
+ * the agents along cycles of up to maxCycle adjacent posts. The best move is
+ * applied until none reduces the total cost anymore.
+ *
+ * While playing the posts move little from one frame to the next, so the
+ * assignment of the last frame is close to optimal and one or two moves
+ * repair it. The result is only optimal among these moves, the global solver
+ * is still needed after the formation changed.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "FormationAdjacency.h"
+#include <vector>
+
+class NeighborhoodAssignment
+{
+public:
+	/**
+	 * @param costs square cost matrix, costs[agent][post]
+	 * @param adjacency adjacency of the posts
+	 * @param maxCycle longest cycle of posts to rotate the agents along, 2 = swaps only
+	 * @param locked agent that keeps its post (e.g. the leader), -1 if none
+	 * @param assignment post of each agent, a permutation, improved in place
+	 * @return the total cost of the assignment
+	 */
+	static float improve(const std::vector<std::vector<float> >& costs, const FormationAdjacency& adjacency,
+			unsigned maxCycle, int locked, std::vector<int>& assignment);
+
+private:
+	struct Search
+	{
+		Search(const std::vector<std::vector<float> >& costs, const FormationAdjacency& adjacency, unsigned maxCycle,
+				size_t n) :
+			costs(costs), adjacency(adjacency), maxCycle(maxCycle), agentOf(n, -1), onPath(n, 0)
+		{}
+
+		const std::vector<std::vector<float> >& costs;
+		const FormationAdjacency& adjacency;
+		unsigned maxCycle;
+		std::vector<int> agentOf; /*< agent on each post, -1 if locked */
+		std::vector<int> path; /*< posts of the cycle being built */
+		std::vector<char> onPath;
+		std::vector<int> bestCycle;
+		float bestDelta = 0.f;
+
+		/**
+		 * Extends the path by the neighbors of its last post that are larger than
+		 * its first one, so every cycle is found once per direction and every swap once
+		 */
+		void extend();
+
+		/**
+		 * Evaluates moving the agent on each post of the path to the next one
+		 */
+		void evaluate();
+	};
+};
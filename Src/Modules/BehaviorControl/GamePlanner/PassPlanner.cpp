@@ -1,18 +1,113 @@
-/*
- * PassPlanner.cpp
+/**
+ * @file PassPlanner.cpp
  *
- *  Created on: Jun 1, 2016
- *      Author: novin
+ * Scores a grid of pass targets and provides the best ones as pass options
+ *
+ * @author Novin Shahroudi
+ *
+ * @date 1 Jun, 2016
  */
 
 #include "PassPlanner.h"
+#include "Tools/Debugging/DebugDrawings.h"
+#include "Tools/Debugging/Stopwatch.h"
+#include "Tools/Math/Transformation.h"
+#include <algorithm>
+
+MAKE_MODULE(PassPlanner, behaviorControl)
+
+PassPlanner::PassPlanner()
+{
+}
+
+void PassPlanner::update(PassOptions& passOptions)
+{
+	DECLARE_DEBUG_DRAWING("module:PassPlanner", "drawingOnField");
+
+	if(!scorer.size())
+		buildGrid();
+
+	PassScorer::Parameters& p = scorer.parameters;
+	p.minPassDistance = minPassDistance;
+	p.maxKickDistance = maxKickDistance;
+	p.passSpeed = passSpeed;
+	p.laneWidth = laneWidth;
+	p.timeWeight = timeWeight;
+	p.laneWeight = laneWeight;
+	p.kickWeight = kickWeight;
+	p.progressWeight = progressWeight;
+	p.postWeight = postWeight;
+	p.fieldLength = theFieldDimensions.xPosOpponentGroundline - theFieldDimensions.xPosOwnGroundline;
 
-PassPlanner::PassPlanner() {
-	// TODO Auto-generated constructor stub
+	updateRobots();
 
+	// spread the candidates over frames if the grid is bigger than the budget
+	const size_t numOfCandidates = scorer.size();
+	size_t budget = std::min<size_t>(std::max(candidatesPerFrame, 1u), numOfCandidates);
+	STOPWATCH("PassPlanner:scoreCandidates")
+	{
+		while(budget)
+		{
+			const size_t end = std::min(nextCandidate + budget, numOfCandidates);
+			scorer.score(nextCandidate, end, ball.x(), ball.y(), receivers, opponents);
+			budget -= end - nextCandidate;
+			nextCandidate = end == numOfCandidates ? 0 : end;
+		}
+	}
+
+	std::vector<size_t> best;
+	scorer.rank(numOfPassOptions, best);
+
+	passOptions.options.clear();
+	for(size_t i = 0; i < best.size(); i++)
+	{
+		const size_t c = best[i];
+		PassOption option;
+		option.target = Vector2f(scorer.candidateX[c], scorer.candidateY[c]);
+		option.receiver = scorer.receiver[c];
+		option.score = scorer.scores[c];
+		option.receiverTime = scorer.receiverTime[c];
+		passOptions.options.push_back(option);
+
+		LINE("module:PassPlanner", ball.x(), ball.y(), option.target.x(), option.target.y(),
+				20, Drawings::solidPen, i ? ColorRGBA::orange : ColorRGBA::red);
+		DRAWTEXT("module:PassPlanner", option.target.x(), option.target.y(), 100,
+				ColorRGBA::white, option.receiver);
+	}
 }
 
-PassPlanner::~PassPlanner() {
-	// TODO Auto-generated destructor stub
+void PassPlanner::buildGrid()
+{
+	scorer.buildGrid(theFieldDimensions.xPosOwnGroundline + gridSpacing / 2.f, theFieldDimensions.xPosOpponentGroundline,
+			theFieldDimensions.yPosRightSideline + gridSpacing / 2.f, theFieldDimensions.yPosLeftSideline, gridSpacing);
+	nextCandidate = 0;
 }
 
+void PassPlanner::updateRobots()
+{
+	ball = theTeamBallModel.position;
+
+	// everybody but the passer can receive
+	receivers.clear();
+	for(auto& teammate : theTeammateData.teammates)
+	{
+		if(teammate.status != Teammate::PLAYING || teammate.number == theRobotInfo.number)
+			continue;
+
+		Vector2f post;
+		if(!theAgentTask.getAssignedPost(teammate.number, post))
+			post = teammate.pose.translation;
+
+		receivers.push_back(PassScorer::Receiver{teammate.number, teammate.pose.translation.x(), teammate.pose.translation.y(),
+				post.x(), post.y()});
+	}
+
+	opponents.clear();
+	for(auto& obstacle : theObstacleModel.obstacles)
+		if(obstacle.type == Obstacle::opponent || obstacle.type == Obstacle::fallenOpponent ||
+				obstacle.type == Obstacle::someRobot || obstacle.type == Obstacle::fallenSomeRobot)
+		{
+			const Vector2f position = Transformation::robotToField(theRobotPose, obstacle.center);
+			opponents.push_back(PassScorer::Opponent{position.x(), position.y()});
+		}
+}
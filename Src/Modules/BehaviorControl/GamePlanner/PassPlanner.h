@@ -1,17 +1,89 @@
-/*
- * PassPlanner.h
+/**
+ * @file PassPlanner.h
  *
- *  Created on: Jun 1, 2016
- *      Author: novin
+ * Scores a grid of pass targets and provides the best ones as pass options
+ *
+ * The candidates are scored by a PassScorer (see PassScorer.h) with the
+ * robots of the current frame, at most candidatesPerFrame per frame.
+ *
+ * @author Novin Shahroudi
+ *
+ * @date 1 Jun, 2016
  */
 
-#ifndef SRC_MODULES_MODELING_GAMEPLANNER_PASSPLANNER_H_
-#define SRC_MODULES_MODELING_GAMEPLANNER_PASSPLANNER_H_
+#pragma once
 
-class PassPlanner {
+#include "Tools/Module/Module.h"
+#include "PassScorer.h"
+#include "Representations/Infrastructure/RobotInfo.h"
+#include "Representations/Configuration/FieldDimensions.h"
+#include "Representations/Modeling/RobotPose.h"
+#include "Representations/Modeling/ObstacleModel.h"
+#include "Representations/Modeling/TeamBallModel.h"
+#include "Representations/Communication/TeammateData.h"
+#include "Representations/BehaviorControl/AgentTask.h"
+#include "Representations/BehaviorControl/PassOptions.h"
+
+MODULE(PassPlanner,
+{,
+	REQUIRES(RobotInfo),
+	REQUIRES(FieldDimensions),
+	REQUIRES(RobotPose),
+	REQUIRES(ObstacleModel),
+	REQUIRES(TeamBallModel),
+	REQUIRES(TeammateData),
+	REQUIRES(AgentTask),
+	PROVIDES(PassOptions),
+	LOADS_PARAMETERS(
+	{,
+		(float)(500.f)	gridSpacing,				// distance between candidate targets (mm)
+		(unsigned)(256)	candidatesPerFrame,	// number of candidates scored per frame
+		(unsigned)(5)		numOfPassOptions,		// number of options provided
+		(float)(1000.f)	minPassDistance,		// shortest reasonable pass (mm)
+		(float)(5000.f)	maxKickDistance,		// longest reachable pass (mm)
+		(float)(1500.f)	passSpeed,					// average ball speed of a pass (mm/s)
+		(float)(300.f)	laneWidth,					// clearance needed around the pass lane (mm)
+		(float)(1.f)		timeWeight,
+		(float)(1.f)		laneWeight,
+		(float)(0.5f)		kickWeight,
+		(float)(1.f)		progressWeight,
+		(float)(0.5f)		postWeight,					// how much leaving the assigned post is penalized
+	}),
+});
+
+class PassPlanner : public PassPlannerBase {
 public:
+	/**
+	 * Default constructor
+	 */
 	PassPlanner();
-	virtual ~PassPlanner();
-};
 
-#endif /* SRC_MODULES_MODELING_GAMEPLANNER_PASSPLANNER_H_ */
+	/**
+	 * Default destructor
+	 */
+	virtual ~PassPlanner() {}
+
+	/**
+	 * Main update
+	 */
+	void update(PassOptions& passOptions);
+
+private:
+	/**
+	 * Creates the candidate targets inside the field lines
+	 */
+	void buildGrid();
+
+	/**
+	 * Gathers positions of receivers and opponents for this frame
+	 */
+	void updateRobots();
+
+	PassScorer scorer; /*< the candidates and their scores */
+	size_t nextCandidate = 0; /*< first candidate to be scored in the next frame */
+
+	// robots of this frame ----------------------------------------------------
+	std::vector<PassScorer::Receiver> receivers;
+	std::vector<PassScorer::Opponent> opponents;
+	Vector2f ball;
+};
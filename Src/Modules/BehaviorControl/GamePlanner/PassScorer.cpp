@@ -0,0 +1,122 @@
+/**
+ * @file PassScorer.cpp
+ *
+ * Scoring of a grid of pass targets
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "PassScorer.h"
+#include "Tools/TimeCost.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void PassScorer::buildGrid(float xMin, float xMax, float yMin, float yMax, float spacing)
+{
+	candidateX.clear();
+	candidateY.clear();
+	for(float x = xMin; x < xMax; x += spacing)
+		for(float y = yMin; y < yMax; y += spacing)
+		{
+			candidateX.push_back(x);
+			candidateY.push_back(y);
+		}
+
+	scores.assign(candidateX.size(), -std::numeric_limits<float>::infinity());
+	receiverTime.assign(candidateX.size(), 0.f);
+	receiver.assign(candidateX.size(), -1);
+}
+
+void PassScorer::score(size_t begin, size_t end, float ballX, float ballY, const std::vector<Receiver>& receivers,
+		const std::vector<Opponent>& opponents)
+{
+	const Parameters& p = parameters;
+	const size_t n = end - begin;
+	const float* x = candidateX.data() + begin;
+	const float* y = candidateY.data() + begin;
+	float* s = scores.data() + begin;
+	float* tReceiver = receiverTime.data() + begin;
+	int* r = receiver.data() + begin;
+
+	const float infinity = std::numeric_limits<float>::infinity();
+	const float timeHorizon = 5.f; /*< time advantage that counts as totally safe */
+
+	bestCost.assign(n, infinity);
+	tOpponent.assign(n, infinity);
+	clearance.assign(n, infinity);
+	for(size_t i = 0; i < n; i++)
+	{
+		tReceiver[i] = infinity;
+		r[i] = -1;
+	}
+
+	// best receiver: time to the target plus time to get back to its post
+	for(const Receiver& k : receivers)
+		for(size_t i = 0; i < n; i++)
+		{
+			const float t = restToRestTime(std::sqrt((x[i] - k.x) * (x[i] - k.x) + (y[i] - k.y) * (y[i] - k.y)), p.maxA, p.maxV);
+			const float cost = t + p.postWeight * std::sqrt((x[i] - k.postX) * (x[i] - k.postX) +
+					(y[i] - k.postY) * (y[i] - k.postY)) / p.maxV;
+			const bool better = cost < bestCost[i];
+			bestCost[i] = better ? cost : bestCost[i];
+			tReceiver[i] = better ? t : tReceiver[i];
+			r[i] = better ? k.number : r[i];
+		}
+
+	// fastest opponent and clearance of the lane ball -> target
+	for(const Opponent& opponent : opponents)
+	{
+		const float ox = opponent.x - ballX, oy = opponent.y - ballY;
+		for(size_t i = 0; i < n; i++)
+		{
+			const float dx = x[i] - ballX, dy = y[i] - ballY;
+			const float t = restToRestTime(std::sqrt((x[i] - opponent.x) * (x[i] - opponent.x) +
+					(y[i] - opponent.y) * (y[i] - opponent.y)), p.maxA, p.maxV);
+			tOpponent[i] = std::min(tOpponent[i], t);
+
+			const float along = std::max(0.f, std::min(1.f, (ox * dx + oy * dy) / std::max(dx * dx + dy * dy, 1.f)));
+			const float ex = ox - along * dx, ey = oy - along * dy;
+			clearance[i] = std::min(clearance[i], std::sqrt(ex * ex + ey * ey));
+		}
+	}
+
+	// combine
+	for(size_t i = 0; i < n; i++)
+	{
+		const float dx = x[i] - ballX, dy = y[i] - ballY;
+		const float passDistance = std::sqrt(dx * dx + dy * dy);
+		const float tBall = passDistance / p.passSpeed;
+
+		const float timeScore = std::max(-1.f, std::min(1.f,
+				(tOpponent[i] - std::max(tReceiver[i], tBall)) / timeHorizon));
+		const float laneScore = std::max(-1.f, std::min(1.f, (clearance[i] - p.laneWidth) / p.laneWidth));
+		const float kickScore = 1.f - passDistance / p.maxKickDistance;
+		const float progressScore = dx / p.fieldLength;
+
+		const bool reachable = passDistance >= p.minPassDistance && passDistance <= p.maxKickDistance && r[i] >= 0;
+		const float total = p.timeWeight * timeScore + p.laneWeight * laneScore + p.kickWeight * kickScore +
+				p.progressWeight * progressScore;
+		s[i] = reachable ? total : -infinity;
+	}
+}
+
+void PassScorer::rank(size_t count, std::vector<size_t>& best) const
+{
+	const size_t numOfCandidates = size();
+	ranking.resize(numOfCandidates);
+	for(size_t i = 0; i < numOfCandidates; i++)
+		ranking[i] = i;
+	count = std::min(count, numOfCandidates);
+	std::partial_sort(ranking.begin(), ranking.begin() + count, ranking.end(),
+			[this](size_t a, size_t b) { return scores[a] > scores[b]; });
+
+	best.clear();
+	for(size_t i = 0; i < count; i++)
+	{
+		const size_t c = ranking[i];
+		if(receiver[c] < 0 || scores[c] == -std::numeric_limits<float>::infinity())
+			break;
+		best.push_back(c);
+	}
+}
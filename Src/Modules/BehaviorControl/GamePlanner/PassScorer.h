@@ -0,0 +1,85 @@
+/**
+ * @file PassScorer.h
+ *
+ * Scoring of a grid of pass targets, the core of the PassPlanner without the
+ * module framework, so it can also be run offline (see Util/PassPlannerBenchmark).
+ *
+ * Each candidate target is scored by the time the best receiver needs to get
+ * there compared to the opponents, the clearance of the lane from the ball to
+ * the target, a kick range model and the progress towards the opponent goal.
+ * Candidates are stored as arrays (x, y, score, ...) and each term is
+ * evaluated for all candidates in one branchless loop per robot, which the
+ * compiler can vectorize.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class PassScorer
+{
+public:
+	struct Parameters
+	{
+		float minPassDistance = 1000.f; /*< shortest reasonable pass (mm) */
+		float maxKickDistance = 5000.f; /*< longest reachable pass (mm) */
+		float passSpeed = 1500.f; /*< average ball speed of a pass (mm/s) */
+		float laneWidth = 300.f; /*< clearance needed around the pass lane (mm) */
+		float timeWeight = 1.f;
+		float laneWeight = 1.f;
+		float kickWeight = 0.5f;
+		float progressWeight = 1.f;
+		float postWeight = 0.5f; /*< how much leaving the assigned post is penalized */
+		float fieldLength = 9000.f; /*< mm */
+		float maxA = 16.f; /*< motion model of the robots, same as in the task assignment */
+		float maxV = 220.f;
+	};
+
+	struct Receiver
+	{
+		int number; /*< player number */
+		float x, y; /*< global position */
+		float postX, postY; /*< assigned post, the position if there is none */
+	};
+
+	struct Opponent
+	{
+		float x, y; /*< global position */
+	};
+
+	/**
+	 * Creates the candidate targets in [xMin, xMax) x [yMin, yMax), all unscored
+	 */
+	void buildGrid(float xMin, float xMax, float yMin, float yMax, float spacing);
+
+	/**
+	 * Scores candidates in [begin, end)
+	 */
+	void score(size_t begin, size_t end, float ballX, float ballY, const std::vector<Receiver>& receivers,
+			const std::vector<Opponent>& opponents);
+
+	/**
+	 * Indices of the best scored candidates, best first, without unreachable ones
+	 * @param count maximum number of candidates
+	 */
+	void rank(size_t count, std::vector<size_t>& best) const;
+
+	size_t size() const {return candidateX.size();}
+
+	Parameters parameters;
+
+	// candidates --------------------------------------------------------------
+	std::vector<float> candidateX;
+	std::vector<float> candidateY;
+	std::vector<float> scores; /*< total score of the candidate, -infinity if unreachable */
+	std::vector<float> receiverTime; /*< time of the best receiver */
+	std::vector<int> receiver; /*< player number of the best receiver, -1 if there is none */
+
+private:
+	// buffers of score(), kept to avoid allocations per frame
+	std::vector<float> bestCost, tOpponent, clearance;
+	mutable std::vector<size_t> ranking;
+};
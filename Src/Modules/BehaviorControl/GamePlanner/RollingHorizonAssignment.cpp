@@ -0,0 +1,72 @@
+/**
+ * @file RollingHorizonAssignment.cpp
+ *
+ * Assignment of agents to posts over a number of future steps at once
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "RollingHorizonAssignment.h"
+#include "Tools/HungarianAssignment.h"
+
+float RollingHorizonAssignment::solve(const std::vector<std::vector<std::vector<float> > >& costs,
+		const std::vector<int>& current, float switchPenalty, unsigned maxSweeps, std::vector<std::vector<int> >& plan)
+{
+	const size_t steps = costs.size();
+	const size_t n = steps ? costs[0].size() : 0;
+	std::vector<float> u, v;
+
+	// without a fitting warm start each step is solved on its own first
+	bool warm = plan.size() == steps;
+	for(size_t t = 0; t < plan.size() && warm; t++)
+		warm = plan[t].size() == n;
+	if(!warm)
+	{
+		plan.resize(steps);
+		for(size_t t = 0; t < steps; t++)
+			HungarianAssignment::solve(n, [&](size_t i, size_t j) { return costs[t][i][j]; }, plan[t], u, v);
+	}
+
+	std::vector<int> assignment;
+	for(unsigned sweep = 0; sweep < maxSweeps; sweep++)
+	{
+		bool changed = false;
+		for(size_t t = 0; t < steps; t++)
+		{
+			const std::vector<int>& before = t ? plan[t - 1] : current;
+			const std::vector<int>* after = t + 1 < steps ? &plan[t + 1] : nullptr;
+			HungarianAssignment::solve(n, [&](size_t i, size_t j)
+			{
+				float cost = costs[t][i][j];
+				if(before[i] >= 0 && before[i] != (int)j)
+					cost += switchPenalty;
+				if(after && (*after)[i] != (int)j)
+					cost += switchPenalty;
+				return cost;
+			}, assignment, u, v);
+			if(assignment != plan[t])
+			{
+				plan[t] = assignment;
+				changed = true;
+			}
+		}
+		if(!changed)
+			break;
+	}
+	return cost(costs, current, switchPenalty, plan);
+}
+
+float RollingHorizonAssignment::cost(const std::vector<std::vector<std::vector<float> > >& costs,
+		const std::vector<int>& current, float switchPenalty, const std::vector<std::vector<int> >& plan)
+{
+	float total = 0.f;
+	for(size_t t = 0; t < plan.size(); t++)
+		for(size_t i = 0; i < plan[t].size(); i++)
+		{
+			total += costs[t][i][plan[t][i]];
+			const int before = t ? plan[t - 1][i] : current[i];
+			if(before >= 0 && before != plan[t][i])
+				total += switchPenalty;
+		}
+	return total;
+}
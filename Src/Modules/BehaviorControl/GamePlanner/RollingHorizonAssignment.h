@@ -0,0 +1,45 @@
+/**
+ * @file RollingHorizonAssignment.h
+ *
+ * Assignment of agents to posts over a number of future steps at once, where
+ * changing the post of an agent from one step to the next costs a penalty.
+ * The assignment of the first step is executed, the others keep it from
+ * switching to a post that is only better for a moment.
+ *
+ * The stages are coupled by the penalties only, so the problem is solved by
+ * block coordinate descent: each stage is a linear assignment given the posts
+ * of the agents in the neighboring stages, solved exactly with the Hungarian
+ * method. A sweep over all stages never increases the total cost. The sweeps
+ * stop when nothing changes or after a given number, which bounds the time per
+ * frame. The plan of the last frame is the warm start, so usually one sweep
+ * confirms it.
+ *
+ * The result is a local optimum of the multi-stage problem.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include <vector>
+
+class RollingHorizonAssignment
+{
+public:
+	/**
+	 * @param costs square cost matrix of each step, costs[step][agent][post]
+	 * @param current post of each agent before the first step, -1 if it has none
+	 * @param switchPenalty cost of an agent changing its post between two steps
+	 * @param maxSweeps maximum number of sweeps over all steps
+	 * @param plan post of each agent in each step, plan[step][agent], the warm start if it fits the costs
+	 * @return the total cost of the plan including the penalties
+	 */
+	static float solve(const std::vector<std::vector<std::vector<float> > >& costs, const std::vector<int>& current,
+			float switchPenalty, unsigned maxSweeps, std::vector<std::vector<int> >& plan);
+
+	/**
+	 * Total cost of a plan including the penalties
+	 */
+	static float cost(const std::vector<std::vector<std::vector<float> > >& costs, const std::vector<int>& current,
+			float switchPenalty, const std::vector<std::vector<int> >& plan);
+};
@@ -12,55 +12,64 @@
 
 #include "TaskAssignment.h"
 #include "Tools/Debugging/DebugDrawings.h"
+#include "Tools/Debugging/Stopwatch.h"
+#include "Tools/HungarianAssignment.h"
 #include "Platform/Time.h"
 #include "Platform/File.h"
-#include <dirent.h>
+#include "Tools/Streams/InStreams.h"
+#include <Eigen/Cholesky>
 #include <iostream>
-#include <regex.h>
 #include <algorithm>
+#include <limits>
 
 MAKE_MODULE(TaskAssignment, behaviorControl)
 
-TaskAssignment::TaskAssignment() :
-ballInOwnHalfThre(-1500, 300),
-distanceToTargetThre(750, 100)
+TaskAssignment::TaskAssignment()
 {
-	using namespace std;
-	DIR *dir;
-	struct dirent *ent;
-
-	regex_t regex;
-	int ret;
-
-	//filter cpp and python files with regex
-	const char *pattern = "^.*\\.cfg$";
-	ret = regcomp(&regex, pattern, 0);
-	if(ret)
+	// in the order of Threshold
+	hysteresis.add(-1500.f, 300.f);	// ballInOwnHalf, global x of the ball (mm)
+	hysteresis.add(750.f, 100.f);	// ballNearRobot, distance of the ball to the robot (mm)
+	hysteresis.add(400.f, 0.f);	// ballCellChanged, distance of the ball to its last cell minus the nearest other (mm)
+	hysteresis.add(1.f, 0.f);	// leaderChangedReady, time of the last leader minus the fastest other robot (s)
+	hysteresis.add(2.f, 0.f);	// leaderChangedPlaying, the same
+	ASSERT(hysteresis.size() == numOfThresholds);
+
+	const std::string path = std::string(File::getBHDir()) + "/Config/Formations/";
+	if(watchFormations)
 	{
-		std::cerr << "could not compile the regex!" << std::endl;
-		exit(EXIT_FAILURE);
+		formationWatcher = FormationWatcher::shared(path);
+		formationCatalog = formationWatcher->catalog();
 	}
+	else
+		formationCatalog = FormationCatalog::shared(path);
 
-	std::string path = std::string(File::getBHDir()) + "/Config/Formations/";
-	if ((dir = opendir (path.c_str())) != NULL) {
-		/* print all the files and directories within directory */
-		while ((ent = readdir (dir)) != NULL) {
-			ret = regexec(&regex, ent->d_name, 0, NULL, 0);
-			if(!ret)
-			{
-				//	  		printf ("%s\n", ent->d_name);
-				std::vector<VoronoiCell> tmpTile;
-				agentTask.getTilesFromFile((path + ent->d_name).c_str(), tmpTile);
-				formations[ent->d_name] = tmpTile;
-			}
-		}
-		closedir (dir);
-	} else {
-		/* could not open directory */
-		perror ("could not open directory");
-	}
+	auction = AuctionAssignment(auctionEpsilon.x(), auctionEpsilon.y());
+
+	// threads for the hierarchical and the branch-and-bound solver and the formation versions
+	if(hierarchicalAssignment || crossingPenalty > 0.f || !formationVersions.empty())
+		threadPool.reset(new ThreadPool(std::max(std::thread::hardware_concurrency(), 1u) - 1));
+
+	timeCostTable.build();
+
+	// optional, see Util/LatticeGenerator
+	latticeCosts.load(std::string(File::getBHDir()) + "/Config/Locations/Default/latticeCosts.bin");
 
-	regfree(&regex);
+	// fitted motion limits per robot, see Util/MotionProfileFitter
+	InMapFile stream("motionProfiles.cfg");
+	if(stream.exists())
+		stream >> motionProfiles;
+
+	// the table is normalized, its error grows with maxV / maxA of the profiles
+	std::vector<MotionProfile> profiles = motionProfiles.robots;
+	profiles.push_back(motionProfiles.defaultProfile);
+	for(const MotionProfile& profile : profiles)
+		for(const MotionLimits& limits : {profile.forward, profile.sideways, profile.turning})
+		{
+			const float error = timeCostTable.maxErrorFor(limits.maxA, limits.maxV);
+			if(error > maxTimeCostError)
+				std::cerr << "timeCost table error of " << error << " s for player " << profile.number
+									<< " (maxA " << limits.maxA << ", maxV " << limits.maxV << ") exceeds maxTimeCostError" << std::endl;
+		}
 }
 
 void TaskAssignment::update(AgentTask& agentTask)
@@ -76,12 +85,34 @@ void TaskAssignment::update(AgentTask& agentTask)
 		return;
 	}
 
+	// formations edited meanwhile, the old catalog and the pointers into it are kept
+	// until updateFormation loaded the formation from the new one
+	if(formationWatcher)
+	{
+		std::shared_ptr<const FormationCatalog> catalog = formationWatcher->catalog();
+		if(catalog != formationCatalog && catalog != pendingCatalog)
+		{
+			pendingCatalog = catalog;
+			formationReloaded = true;
+		}
+	}
+
+	updateHysteresis();
 	updateBasicPlan();
+	updateTeammatePredictions();
+
+	// the own covariance as the teammates know it, i.e. as of the last team message
+	if(theFrameInfo.getTimeSince(sentCovarianceTime) >= teamMessageInterval)
+	{
+		sentCovariance = theRobotPose.covariance;
+		sentCovarianceTime = theFrameInfo.time;
+	}
 
 	if(theGameInfo.state == STATE_READY || theGameInfo.state == STATE_SET ||
 			theGameInfo.state == STATE_PLAYING)
 	{
 		updateFormation();
+		updateFormationTransform();
 		updatePost();
 	}
 
@@ -101,6 +132,24 @@ void TaskAssignment::update(AgentTask& agentTask)
 
 }
 
+void TaskAssignment::update(AuctionMessage& auctionMessage)
+{
+	auctionMessage.sender = theRobotInfo.number;
+	auctionMessage.key = auction.key();
+	auctionMessage.phase = auction.phase();
+	auctionMessage.prices = auction.prices();
+	auctionMessage.owners = auction.owners();
+}
+
+void TaskAssignment::updateHysteresis()
+{
+	float inputs[numOfFrameThresholds];
+	inputs[ballInOwnHalf] = theTeamBallModel.position.x();
+	inputs[ballNearRobot] = theBallModel.estimate.position.norm();
+	hysteresis.update(inputs, numOfFrameThresholds);
+	MODIFY("module:TaskAssignment:hysteresis", hysteresis);
+}
+
 void TaskAssignment::calculateHasBallMoved()
 {
 	if (theGameInfo.state != STATE_PLAYING)
@@ -210,7 +259,7 @@ void TaskAssignment::updateFormation()
 	bool kickoffushaschanged =
 			kickoffus xor (theGameInfo.kickOffTeam == theOwnTeamInfo.teamNumber);
 	bool formationNeedToChange = gameStateHasChanged or
-			(lastFrameNumOfPlayers xor numOfPlayers) or kickoffushaschanged;
+			(lastFrameNumOfPlayers xor numOfPlayers) or kickoffushaschanged or formationReloaded;
 
 	// change formation if necessary
 	if(!formationNeedToChange)
@@ -229,61 +278,335 @@ void TaskAssignment::updateFormation()
 			(gameState == STATE_READY || gameState == STATE_SET) ? "_ready" : "_playing";
 	string numOfPlayers_str = "_" + toString(numOfPlayers) + "player";
 	string kickoff_str = kickoffus ? "_kickoffus" : "";
-	string strategyVersion_str = "_" + toString(formationVersion);
-
-	formationToLoad = std::string("formation") + gameState_str + numOfPlayers_str +
-			kickoff_str + strategyVersion_str + std::string(".cfg");
 
 	// mirror formation positions when a goal achieved, either by us or the opponent
 	if((gameStateHasChanged && kickoffus &&
 			theGameInfo.state == STATE_READY ) && dynamicPostAssign)
-		for(std::map<std::string,
-				std::vector<VoronoiCell> >::iterator ii =
-						formations.begin(); ii != formations.end(); ++ii)
-		{
-			for(std::vector<VoronoiCell>::iterator jj =
-					ii->second.begin(); jj != ii->second.end(); ++jj)
-				(*jj).mirrorY();
-		}
+	{
+		mirrored = !mirrored;
+	}
+
+	const string prefix = std::string("formation") + gameState_str + numOfPlayers_str + kickoff_str + "_";
+	const FormationCatalog& catalog = pendingCatalog ? *pendingCatalog : *formationCatalog;
+	formationToLoad = prefix + toString(selectFormationVersion(prefix, catalog)) + std::string(".cfg");
 
-	std::map<std::string, std::vector<VoronoiCell> >::iterator res =
-			formations.find(formationToLoad);
+	const std::vector<VoronoiCell>* formation = catalog.formation(formationToLoad);
 
-	if(res == formations.end())
+	if(!formation)
 	{
-		std::cerr << "loading formation failed: " << formationToLoad << std::endl;
-		ASSERT(false);
+		// e.g. a file being edited was moved away, the current formation is kept until it is back
+		std::cerr << "loading formation failed: " << formationToLoad;
+		if(!lastSetFormation.empty())
+			std::cerr << ", keeping " << formationName;
+		std::cerr << std::endl;
+		ASSERT(formationReloaded || !lastSetFormation.empty());
+		formationReloaded = false;
 	}
 	else
 	{
 		//		OUTPUT_WARNING(theRobotInfo.number << " :: loading formation: " << formationToLoad);
-		agentTask.load(res->second);
-		lastSetFormation = res->second;
+		if(pendingCatalog)
+			formationCatalog = std::move(pendingCatalog); // frees the old catalog if no other robot holds it
+		lastSetFormation = *formation;
+		formationName = formationToLoad;
+		adjacency = formationCatalog->adjacency(formationToLoad);
+		if(mirrored)
+			for(VoronoiCell& cell : lastSetFormation)
+				cell.mirrorY();
+		agentTask.load(lastSetFormation);
+		formationSerial++;
+		formationTransformDirty = true;
+		formationReloaded = false;
+
+		activeBallFormation = formationCatalog->ballFormation(formationToLoad);
+		if(activeBallFormation && mirrored)
+		{
+			mirroredBallFormation = *activeBallFormation;
+			mirroredBallFormation.mirrorY();
+			activeBallFormation = &mirroredBallFormation;
+		}
 	}
 }
 
-const Teammate& TaskAssignment::getAgentByPlayerNumber(const int& playerNumber)
+int TaskAssignment::selectFormationVersion(const std::string& prefix, const FormationCatalog& catalog)
 {
+	std::vector<int> versions(1, formationVersion);
+	for(int version : formationVersions)
+		if(std::find(versions.begin(), versions.end(), version) == versions.end())
+			versions.push_back(version);
+
+	std::vector<int> candidates;
+	std::vector<const std::vector<VoronoiCell>*> formations;
+	for(int version : versions)
+	{
+		const std::vector<VoronoiCell>* formation = catalog.formation(prefix + toString(version) + ".cfg");
+		if(formation)
+		{
+			candidates.push_back(version);
+			formations.push_back(formation);
+		}
+	}
+	if(candidates.empty())
+		return formationVersion;
+
+	// the version chosen last for the same situation stays for the dwell time
+	const int current = prefix == selectedPrefix ? selectedVersion : -1;
+	const auto select = [&](int version)
+	{
+		if(version != current)
+		{
+			selectedVersion = version;
+			selectedPrefix = prefix;
+			versionSelectedTime = theFrameInfo.time;
+		}
+		return version;
+	};
+	const bool dwelling = theFrameInfo.getTimeSince(versionSelectedTime) < formationDwell &&
+			std::find(candidates.begin(), candidates.end(), current) != candidates.end();
+	if(candidates.size() == 1 || dwelling)
+		return select(dwelling ? current : candidates[0]);
+
+	// the agents of the post assignment
+	std::vector<int> numbers(1, theRobotInfo.number);
+	std::vector<Pose2f> poses(1, theRobotPose);
 	for(auto& teammate : theTeammateData.teammates)
-		if(teammate.number == playerNumber) {
-			return teammate;
+		if(!teammate.isGoalkeeper && teammate.status != Teammate::PENALIZED)
+		{
+			numbers.push_back(teammate.number);
+			poses.push_back(predictedPose(teammate));
+		}
+
+	// the time-to-pose model only, the obstacles and the uncertainty are the same for all versions
+	std::vector<float> totals(candidates.size(), INFINITY);
+	const auto evaluate = [&](size_t k)
+	{
+		std::vector<VoronoiCell> cells = *formations[k];
+		const size_t n = poses.size();
+		if(cells.size() != n)
+			return;
+		std::vector<float> costs(n * n);
+		for(size_t j = 0; j < n; j++)
+		{
+			if(mirrored)
+				cells[j].mirrorY();
+			for(size_t i = 0; i < n; i++)
+			{
+				const Vector2f target = Transformation::fieldToRobot(poses[i], cells[j].globalPose().translation);
+				const float rotation = Angle::normalize(cells[j].globalPose().rotation - poses[i].rotation);
+				costs[i * n + j] = motionProfiles.forPlayer(numbers[i]).timeToPose(timeCostTable, target, rotation,
+						robotTranslationSpeed);
+			}
 		}
+		std::vector<int> assignment;
+		std::vector<float> u, v;
+		totals[k] = HungarianAssignment::solve(n, [&](size_t i, size_t j) { return costs[i * n + j]; }, assignment, u, v);
+	};
+	STOPWATCH("TaskAssignment:selectFormation")
+	{
+		if(threadPool)
+			threadPool->parallelFor(candidates.size(), evaluate);
 		else
-			continue;
+			for(size_t k = 0; k < candidates.size(); k++)
+				evaluate(k);
+	}
 
-	throw "no teammate found by the given index";
+	// no version has a post for each agent
+	const float best = *std::min_element(totals.begin(), totals.end());
+	if(best == INFINITY)
+	{
+		std::cerr << "no version of " << prefix << " fits " << poses.size() << " agents, keeping version "
+				<< formationVersion << std::endl;
+		return formationVersion;
+	}
+
+	// each robot knows the poses a bit differently, so versions within the margin
+	// of the best count as a tie, which is resolved the same way on all robots:
+	// the current version stays, otherwise the first one of the list is taken
+	size_t chosen = candidates.size();
+	for(size_t k = 0; k < candidates.size(); k++)
+		if(totals[k] <= best + formationMargin &&
+				(chosen == candidates.size() || candidates[k] == current))
+			chosen = k;
+	return select(candidates[chosen]);
+}
+
+void TaskAssignment::updateFormationTransform()
+{
+	// posts are only shifted while playing, ready/set positions must stay legal
+	const bool shifted = (ballRelativeFormation || activeBallFormation) &&
+			theGameInfo.state == STATE_PLAYING;
+
+	// field dimensions don't change during the game
+	if(!fieldBoundsRead)
+	{
+		fieldLowerBound = Vector2f(theFieldDimensions.xPosOwnGroundline, theFieldDimensions.yPosRightSideline);
+		fieldSize = Vector2f(theFieldDimensions.xPosOpponentGroundline,
+				theFieldDimensions.yPosLeftSideline) - fieldLowerBound;
+		fieldBoundsRead = true;
+	}
+
+	if(!formationTransformDirty && shifted == lastTransformShifted &&
+			(!shifted || (theTeamBallModel.position - lastTransformBall).norm() <= ballRelativeEpsilon))
+		return;
+
+	if(shifted)
+	{
+		lastTransformBall = theTeamBallModel.position;
+		if(activeBallFormation)
+		{
+			// blended posts may be triangulated differently than the ones of the file
+			activeBallFormation->evaluate(lastTransformBall, postPositions, ballFormationTriangle);
+			blendedAdjacency = FormationAdjacency(postPositions);
+			adjacency = &blendedAdjacency;
+		}
+		else
+		{
+			// a shift common to all posts keeps their neighbors
+			ballRelativePosts(lastTransformBall, postPositions);
+			adjacency = formationCatalog->adjacency(formationName);
+		}
+	}
+	else
+	{
+		postPositions.resize(lastSetFormation.size());
+		for(size_t i = 0; i < lastSetFormation.size(); i++)
+			postPositions[i] = lastSetFormation[i].globalPose().translation;
+		adjacency = formationCatalog->adjacency(formationName);
+	}
+
+	lastTransformShifted = shifted;
+	formationTransformDirty = false;
+}
+
+void TaskAssignment::ballRelativePosts(const Vector2f& ball, std::vector<Vector2f>& posts) const
+{
+	// change voronoi center position relative to ball position in the field
+	// ball differential in the field range is scaled in voronoi range for that specific post/voronoi position
+	// relation => r_p_g(t) = [(r_p_g(t0) - c) * (1 - ∆r_b_g(t,t0))] + [(r_p_g(t0) + c) * ∆r_b_g(t,t0)]
+	// simplified => r_p_g(t) = r_p_g(t0) - c + [2c * ∆r_b_g(t, t0)]
+	// r_p_g: global voronoi position
+	// c: raidus that voronoi position can change
+	// ∆r_b_g: global ball position variation while it is [0, 1]
+	// t0: the initial position, i.e. loaded from the formation in case of voronoi positions
+	//
+	// the shift term only depends on the ball, so it's computed once and then
+	// added to all posts of the formation in a single pass
+
+	// ratio of ball in absolute bound of its lower/upper limits
+	const Vector2f ballRatioInAbsBound = (ball - fieldLowerBound).cwiseQuotient(fieldSize);
+	const Vector2f shift = ballRelativeRadius.cwiseProduct(2.f * ballRatioInAbsBound - Vector2f::Ones());
+
+	posts.resize(lastSetFormation.size());
+	for(size_t i = 0; i < lastSetFormation.size(); i++)
+		posts[i] = lastSetFormation[i].globalPose().translation + shift;
+}
+
+const Teammate* TaskAssignment::getAgentByPlayerNumber(int playerNumber) const
+{
+	for(auto& teammate : theTeammateData.teammates)
+		if(teammate.number == playerNumber)
+			return &teammate;
+	return nullptr;
+}
+
+Pose2f TaskAssignment::agentPose(int playerNumber) const
+{
+	if(playerNumber == theRobotInfo.number)
+		return theRobotPose;
+	const Teammate* teammate = getAgentByPlayerNumber(playerNumber);
+	ASSERT(teammate);
+	return teammate ? predictedPose(*teammate) : Pose2f();
+}
+
+void TaskAssignment::updateTeammatePredictions()
+{
+	const size_t n = theTeammateData.teammates.size();
+	predictedNumber.resize(n);
+	predictedX.resize(n);
+	predictedY.resize(n);
+	predictedRotation.resize(n);
+	std::vector<float> vx(n), vy(n), vr(n), dt(n);
+
+	// gather the last pose and the velocity over the history of each teammate
+	for(size_t i = 0; i < n; i++)
+	{
+		const Teammate& teammate = theTeammateData.teammates[i];
+		std::vector<TeammateHistory>::iterator history = std::find_if(teammateHistories.begin(), teammateHistories.end(),
+				[&teammate](const TeammateHistory& h) { return h.number == teammate.number; });
+		if(history == teammateHistories.end())
+		{
+			teammateHistories.push_back(TeammateHistory());
+			history = teammateHistories.end() - 1;
+			history->number = teammate.number;
+		}
+
+		RingBuffer<PoseSample, 4>& samples = history->samples;
+		if(!samples.empty() && (int)(teammate.timeWhenLastPacketReceived - samples[0].time) > maxExtrapolation)
+			samples.clear();
+		if(samples.empty() || samples[0].time != teammate.timeWhenLastPacketReceived)
+			samples.push_front(PoseSample{teammate.timeWhenLastPacketReceived, teammate.pose});
+
+		const PoseSample& newest = samples[0];
+		const PoseSample& oldest = samples[samples.size() - 1];
+		const float span = std::max((float)(newest.time - oldest.time) / 1000.f, 0.001f);
+		const MotionProfile& profile = motionProfiles.forPlayer(teammate.number);
+		Vector2f velocity = (newest.pose.translation - oldest.pose.translation) / span;
+		if(velocity.norm() > profile.forward.maxV)
+			velocity *= profile.forward.maxV / velocity.norm();
+
+		predictedNumber[i] = teammate.number;
+		predictedX[i] = newest.pose.translation.x();
+		predictedY[i] = newest.pose.translation.y();
+		predictedRotation[i] = newest.pose.rotation;
+		vx[i] = velocity.x();
+		vy[i] = velocity.y();
+		vr[i] = std::max(-profile.turning.maxV, std::min(profile.turning.maxV,
+				Angle::normalize(newest.pose.rotation - oldest.pose.rotation) / span));
+		dt[i] = (float)std::min(theFrameInfo.getTimeSince(newest.time) + teammateLatency, maxExtrapolation) / 1000.f;
+	}
+
+	// constant velocity extrapolation to the current frame
+	for(size_t i = 0; i < n; i++)
+	{
+		predictedX[i] += vx[i] * dt[i];
+		predictedY[i] += vy[i] * dt[i];
+		predictedRotation[i] = Angle::normalize(predictedRotation[i] + vr[i] * dt[i]);
+	}
+
+	for(size_t i = 0; i < n; i++)
+		LINE("module:TaskAssignment", theTeammateData.teammates[i].pose.translation.x(),
+				theTeammateData.teammates[i].pose.translation.y(), predictedX[i], predictedY[i],
+				20, Drawings::dottedPen, ColorRGBA::gray);
+}
+
+Pose2f TaskAssignment::predictedPose(const Teammate& teammate) const
+{
+	for(size_t i = 0; i < predictedNumber.size(); i++)
+		if(predictedNumber[i] == teammate.number)
+			return Pose2f(predictedRotation[i], predictedX[i], predictedY[i]);
+	return teammate.pose;
 }
 
 void TaskAssignment::costOfRobotToPost(std::vector<std::vector<float> > &c,
-		const std::vector<int> &agent)
+		const std::vector<int> &agent, const std::vector<Pose2f>* poses)
 {
 	using namespace std;
-	Vector2f target;
+	Pose2f pose;
 	//	float xP = 0, xR = 0, yP = 0, yR = 0, t = 0;
 
-	float td = 0, th = 0, t = 0, d =0, h = 0;
+	float t = 0;
+	std::vector<Pose2f> agentPoses(c.size());
+	std::vector<Matrix3f> agentCovariances(c.size(), Matrix3f::Zero());
 
-	vector<VoronoiCell> position = agentTask.cells();
+	// path lengths around the other robots, straight lines if it takes too long
+	std::vector<std::vector<float> > pathLength;
+	std::vector<std::vector<Vector2f> > pathVia;
+	bool aroundObstacles = false;
+	if(obstacleAwareCosts)
+	{
+		STOPWATCH("TaskAssignment:obstaclePaths")
+			aroundObstacles = obstaclePaths(agent, pathLength, pathVia, poses);
+	}
 
 	// calculating cost based on time cost
 	for (size_t i = 0; i < c.size() ; i++)
@@ -294,8 +617,8 @@ void TaskAssignment::costOfRobotToPost(std::vector<std::vector<float> > &c,
 
 			if (theRobotInfo.number == agent [i])
 			{
-				target = Transformation::fieldToRobot(theRobotPose,
-						position[j].globalPose().translation);
+				pose = theRobotPose;
+				agentCovariances[i] = sentCovariance;
 				// TODO: uncomment following when next TODO has been done
 				//				if(theMotionInfo.motion == MotionInfo::walk)
 				//					robotTranslationSpeed = theMotionInfo.walkRequest.speed.translation.norm();
@@ -304,13 +627,13 @@ void TaskAssignment::costOfRobotToPost(std::vector<std::vector<float> > &c,
 			}
 			else
 			{
-				try {
-					target =
-							Transformation::fieldToRobot(getAgentByPlayerNumber(agent[i]).pose,
-									position[j].globalPose().translation);
-				} catch (std::string error) {
-					cerr << error << endl;
+				if(const Teammate* teammate = getAgentByPlayerNumber(agent[i]))
+				{
+					pose = predictedPose(*teammate);
+					agentCovariances[i] = teammate->pose.covariance;
 				}
+				else
+					cerr << "no teammate found by the given index" << endl;
 
 				// TODO: we need some motion data to be communicated to incorporate following cost
 				//				robotTranslationSpeed_x = theTeamMateData.motionRequest[agent[i]].walkRequest.speed.translation.x;
@@ -320,25 +643,565 @@ void TaskAssignment::costOfRobotToPost(std::vector<std::vector<float> > &c,
 				//				if (theTeamMateData.motionRequest[i].motion == MotionInfo::stand && target.abs() > distanceToTargetThre)
 				//					standToWalkCost = 2;
 			}
-			d = target.norm();
-			h = target.angle();
-			th = timeCost(h,0,0,0,0.2f,0.25f);
-			td = timeCost(d,robotTranslationSpeed,0,0,16,220);
-			t = th + td + standToWalkCost;
+			if(poses)
+				pose = (*poses)[i];
+			agentPoses[i] = pose;
+
+			// translate and turn to the orientation of the post at the same time
+			Vector2f target = Transformation::fieldToRobot(pose, postPositions[j]);
+			if(aroundObstacles && pathLength[i][j] < std::numeric_limits<float>::infinity())
+			{
+				// the robot may stand on its first waypoint, e.g. on the post, then there is no direction
+				const Vector2f via = Transformation::fieldToRobot(pose, pathVia[i][j]);
+				if(via.squaredNorm() > 0.f)
+					target = via.normalized() * pathLength[i][j];
+			}
+			const float rotation = Angle::normalize(lastSetFormation[j].globalPose().rotation - pose.rotation);
+			const MotionProfile& profile = motionProfiles.forPlayer(agent[i]);
+			t = profile.timeToPose(timeCostTable, target, rotation, robotTranslationSpeed) + standToWalkCost;
+
+			// heading-aware time of the walk primitives at cruise speed, as a distance
+			// plus the detour around the robots in the way, walked with acceleration
+			const float latticeTime = useLatticeCosts && !latticeCosts.empty() ?
+					latticeCosts(pose, Pose2f(lastSetFormation[j].globalPose().rotation, postPositions[j])) : -1.f;
+			if(latticeTime >= 0.f)
+			{
+				const float distance = latticeTime * latticeCosts.forwardV() +
+						target.norm() - (postPositions[j] - pose.translation).norm();
+				t = timeCostTable(distance, robotTranslationSpeed, profile.forward.maxA, profile.forward.maxV) + standToWalkCost;
+			}
 			c[i][j] = t;
+		}
+	}
 
-			CIRCLE("module:TaskAssignment",
-					position[j].globalPose().translation.x(), position[j].globalPose().translation.y(),
-					50, 10, Drawings::solidPen, ColorRGBA::yellow, Drawings::solidPen, ColorRGBA::black);
+	if(monteCarloSamples > 0)
+	{
+		STOPWATCH("TaskAssignment:poseUncertainty")
+			addPoseUncertainty(c, agent, agentPoses, agentCovariances);
+	}
+}
+
+void TaskAssignment::addPoseUncertainty(std::vector<std::vector<float> >& c, const std::vector<int>& agent,
+		const std::vector<Pose2f>& poses, const std::vector<Matrix3f>& covariances)
+{
+	const size_t k = (size_t)monteCarloSamples;
+	std::vector<float> z(3 * k), x(k), y(k), r(k), cost(k);
+
+	for(size_t i = 0; i < c.size(); i++)
+	{
+		// seeded by the player number in every frame, so all robots draw the same
+		// samples for an agent, whatever the order of their agents
+		random.seed((uint32_t)agent[i]);
+
+		// a covariance that is missing or broken is replaced by the fixed inflation
+		Matrix3f l = Matrix3f::Zero();
+		l.diagonal() << poseInflation.x(), poseInflation.x(), poseInflation.y();
+		const Eigen::LLT<Matrix3f> llt(covariances[i]);
+		if(covariances[i](0, 0) + covariances[i](1, 1) > 1.f && llt.info() == Eigen::Success)
+			l = llt.matrixL();
+
+		random.normal(z.data(), 3 * k);
+		const Pose2f& pose = poses[i];
+		for(size_t s = 0; s < k; s++)
+		{
+			const float z0 = z[s], z1 = z[k + s], z2 = z[2 * k + s];
+			x[s] = pose.translation.x() + l(0, 0) * z0;
+			y[s] = pose.translation.y() + l(1, 0) * z0 + l(1, 1) * z1;
+			r[s] = pose.rotation + l(2, 0) * z0 + l(2, 1) * z1 + l(2, 2) * z2;
+		}
+
+		const MotionProfile& profile = motionProfiles.forPlayer(agent[i]);
+		for(size_t j = 0; j < c[i].size(); j++)
+		{
+			const Vector2f& post = postPositions[j];
+			const float postRotation = lastSetFormation[j].globalPose().rotation;
+			for(size_t s = 0; s < k; s++)
+			{
+				const float cs = std::cos(r[s]), sn = std::sin(r[s]);
+				const float dx = post.x() - x[s], dy = post.y() - y[s];
+				cost[s] = profile.timeToPose(timeCostTable, Vector2f(cs * dx + sn * dy, -sn * dx + cs * dy),
+						Angle::normalize(postRotation - r[s]), robotTranslationSpeed);
+			}
+
+			float statistic;
+			if(costQuantile <= 0.f)
+			{
+				statistic = 0.f;
+				for(size_t s = 0; s < k; s++)
+					statistic += cost[s];
+				statistic /= k;
+			}
+			else
+			{
+				const size_t q = std::min(k - 1, (size_t)(costQuantile * k));
+				std::nth_element(cost.begin(), cost.begin() + q, cost.end());
+				statistic = cost[q];
+			}
+
+			// only the effect of the uncertainty is added, so the mode combines with
+			// the path and lattice costs
+			const float nominal = profile.timeToPose(timeCostTable, Transformation::fieldToRobot(pose, post),
+					Angle::normalize(postRotation - pose.rotation), robotTranslationSpeed);
+			c[i][j] += statistic - nominal;
+		}
+	}
+}
+
+bool TaskAssignment::obstaclePaths(const std::vector<int>& agent, std::vector<std::vector<float> >& length,
+		std::vector<std::vector<Vector2f> >& via, const std::vector<Pose2f>* poses)
+{
+	const unsigned long long start = Time::getCurrentThreadTime();
+	const auto inBudget = [&]() { return Time::getCurrentThreadTime() - start <= obstaclePathBudget; };
+
+	// the agents start from and are in the way at the poses the costs are computed for
+	const auto positionOf = [&](int number, const Vector2f& position)
+	{
+		if(poses)
+			for(size_t i = 0; i < agent.size(); i++)
+				if(agent[i] == number)
+					return (*poses)[i].translation;
+		return position;
+	};
+
+	visibilityGraph.clear();
+	visibilityGraph.addObstacle(positionOf(theRobotInfo.number, theRobotPose.translation), obstacleRadius);
+	for(auto& teammate : theTeammateData.teammates)
+		if(teammate.status == Teammate::PLAYING)
+			visibilityGraph.addObstacle(positionOf(teammate.number, predictedPose(teammate).translation), obstacleRadius);
+	for(auto& obstacle : theObstacleModel.obstacles)
+		if(obstacle.type == Obstacle::opponent || obstacle.type == Obstacle::fallenOpponent ||
+				obstacle.type == Obstacle::someRobot || obstacle.type == Obstacle::fallenSomeRobot)
+			visibilityGraph.addObstacle(Transformation::robotToField(theRobotPose, obstacle.center), obstacleRadius);
+
+	std::vector<int> agentNode(agent.size()), postNode(postPositions.size());
+	for(size_t i = 0; i < agent.size(); i++)
+		agentNode[i] = visibilityGraph.addWaypoint(poses ? (*poses)[i].translation : agentPose(agent[i]).translation);
+	for(size_t j = 0; j < postPositions.size(); j++)
+		postNode[j] = visibilityGraph.addWaypoint(postPositions[j]);
+
+	// usually nobody is in the way and the graph is not needed
+	length.assign(agent.size(), std::vector<float>(postPositions.size()));
+	via.assign(agent.size(), std::vector<Vector2f>(postPositions.size()));
+	bool anyBlocked = false;
+	for(size_t i = 0; i < agent.size(); i++)
+		for(size_t j = 0; j < postPositions.size(); j++)
+		{
+			const Vector2f& p = visibilityGraph.node(agentNode[i]);
+			length[i][j] = (postPositions[j] - p).norm();
+			via[i][j] = postPositions[j];
+			anyBlocked = anyBlocked || visibilityGraph.blocked(p, postPositions[j]);
+		}
+	if(!anyBlocked)
+		return true;
+
+	visibilityGraph.build();
+	if(!inBudget())
+		return false;
+
+	// one search per post over the shared graph gives the paths of all agents to it
+	std::vector<float> distance;
+	std::vector<int> next;
+	for(size_t j = 0; j < postPositions.size(); j++)
+	{
+		visibilityGraph.shortestPaths(postNode[j], distance, next);
+		for(size_t i = 0; i < agent.size(); i++)
+		{
+			length[i][j] = distance[agentNode[i]];
+			via[i][j] = next[agentNode[i]] < 0 ? postPositions[j] : visibilityGraph.node(next[agentNode[i]]);
+		}
+		if(!inBudget())
+			return false;
+	}
+
+	COMPLEX_DRAWING("module:TaskAssignment")
+	{
+		for(size_t i = 0; i < agent.size(); i++)
+			for(size_t j = 0; j < postPositions.size(); j++)
+				if(via[i][j] != postPositions[j])
+					LINE("module:TaskAssignment", visibilityGraph.node(agentNode[i]).x(), visibilityGraph.node(agentNode[i]).y(),
+							via[i][j].x(), via[i][j].y(), 10, Drawings::dashedPen, ColorRGBA::gray);
+	}
+	return true;
+}
+
+float TaskAssignment::solveAssignment(const std::vector<std::vector<float> >& costMatrix, int idxOfLeader,
+		int postForLeader, std::vector<int>& permutation, std::vector<std::vector<float> >* reducedCosts) const
+{
+	const int n = (int)costMatrix.size();
+	const bool fixed = postForLeader > -1;
+
+	// the leader keeps its post, the others are assigned to the remaining posts
+	std::vector<int> rows, columns;
+	for(int i = 0; i < n; i++)
+	{
+		if(!fixed || i != idxOfLeader)
+			rows.push_back(i);
+		if(!fixed || i != postForLeader)
+			columns.push_back(i);
+	}
+
+	// large teams are solved line by line, crossing paths need a search, only if all columns are posts
+	const bool postsOnly = costMatrix.size() == lastSetFormation.size();
+	const bool crossing = crossingPenalty > 0.f && postsOnly;
+	const bool hierarchical = !crossing && hierarchicalAssignment && rows.size() >= hierarchicalAssignment && postsOnly;
+
+	std::vector<int> assignment;
+	std::vector<float> u, v;
+	float globalMin;
+	if(crossing)
+	{
+		std::vector<std::vector<float> > costs(rows.size(), std::vector<float>(columns.size()));
+		std::vector<Vector2f> from(rows.size()), to(columns.size());
+		for(size_t i = 0; i < rows.size(); i++)
+		{
+			from[i] = theRobotPose.translation;
+			for(auto& teammate : theTeammateData.teammates)
+				if(teammate.number == agents[rows[i]])
+					from[i] = predictedPose(teammate).translation;
+			for(size_t j = 0; j < columns.size(); j++)
+				costs[i][j] = costMatrix[rows[i]][columns[j]];
+		}
+		for(size_t j = 0; j < columns.size(); j++)
+			to[j] = postPositions[columns[j]];
+
+		const CrossingObjective objective = {costs, from, to, crossingPenalty};
+		STOPWATCH("TaskAssignment:branchAndBound")
+		{
+			globalMin = BranchAndBoundAssignment<CrossingObjective>::solve(rows.size(), objective, threadPool.get(),
+					assignment);
+		}
+	}
+	else if(hierarchical)
+	{
+		std::vector<std::vector<float> > costs(rows.size(), std::vector<float>(columns.size()));
+		std::vector<int> lines(columns.size());
+		for(size_t j = 0; j < columns.size(); j++)
+		{
+			lines[j] = lineOfPost(columns[j]);
+			for(size_t i = 0; i < rows.size(); i++)
+				costs[i][j] = costMatrix[rows[i]][columns[j]];
+		}
+		STOPWATCH("TaskAssignment:hierarchical")
+		{
+			globalMin = HierarchicalAssignment::solve(costs, lines, numOfLines, threadPool.get(), assignment);
+		}
+	}
+	else
+		globalMin = HungarianAssignment::solve(rows.size(),
+				[&](size_t i, size_t j) { return costMatrix[rows[i]][columns[j]]; }, assignment, u, v);
+
+	permutation.resize(n);
+	for(size_t i = 0; i < rows.size(); i++)
+		permutation[rows[i]] = columns[assignment[i]];
+	if(fixed)
+	{
+		permutation[idxOfLeader] = postForLeader;
+		globalMin += costMatrix[idxOfLeader][postForLeader];
+	}
+
+	if(reducedCosts && (hierarchical || crossing))
+		reducedCosts->assign(n, std::vector<float>(n, -INFINITY)); // no duals, never certified
+	else if(reducedCosts)
+	{
+		// the entries of the leader's row and post can't change the assignment
+		reducedCosts->assign(n, std::vector<float>(n, INFINITY));
+		for(size_t i = 0; i < rows.size(); i++)
+			for(size_t j = 0; j < columns.size(); j++)
+				(*reducedCosts)[rows[i]][columns[j]] = costMatrix[rows[i]][columns[j]] - u[i] - v[j];
+		if(fixed)
+			(*reducedCosts)[idxOfLeader][postForLeader] = 0.f;
+	}
+	return globalMin;
+}
+
+float TaskAssignment::planHorizon(int postForLeader, int idxOfLeader, std::vector<int>& permutation)
+{
+	const size_t n = agents.size();
+	const size_t steps = horizonSteps + 1;
+
+	// each agent walks straight to the post it was sent to in the last frame
+	std::vector<Pose2f> start(n);
+	std::vector<Vector2f> target(n);
+	for(size_t i = 0; i < n; i++)
+	{
+		start[i] = agentPose(agents[i]);
+		if(!agentTask.getAssignedPost(agents[i], target[i]))
+			target[i] = start[i].translation;
+	}
+
+	std::vector<std::vector<std::vector<float> > > costs(steps, std::vector<std::vector<float> >(n, std::vector<float>(n)));
+	std::vector<Pose2f> poses(n);
+	std::vector<Vector2f> posts;
+	for(size_t t = 0; t < steps; t++)
+	{
+		const float time = (float)(t * horizonStep) / 1000.f;
+
+		// the posts follow the rolling ball only if the transform shifts them
+		posts = postPositions;
+		if(t && lastTransformShifted)
+		{
+			const Vector2f ball = rollingBall(time);
+			if(activeBallFormation)
+			{
+				int hint = ballFormationTriangle;
+				activeBallFormation->evaluate(ball, posts, hint);
+			}
+			else
+				ballRelativePosts(ball, posts);
+		}
+
+		for(size_t i = 0; i < n; i++)
+		{
+			const Vector2f way = target[i] - start[i].translation;
+			const float distance = std::min(way.norm(), motionProfiles.forPlayer(agents[i]).forward.maxV * time);
+			poses[i] = start[i];
+			if(distance > 0.f)
+				poses[i].translation += way.normalized() * distance;
+		}
+
+		// the cost functions work on postPositions
+		postPositions.swap(posts);
+		costOfRobotToPost(costs[t], agents, t ? &poses : nullptr);
+		postPositions.swap(posts);
+
+		// the leader keeps its post in all steps
+		if(postForLeader > -1)
+		{
+			for(size_t i = 0; i < n; i++)
+			{
+				costs[t][idxOfLeader][i] = forbiddenCost;
+				costs[t][i][postForLeader] = forbiddenCost;
+			}
+			costs[t][idxOfLeader][postForLeader] = 0.f;
+		}
+	}
+
+	// the plan of the last frame is the warm start and its first step is where the
+	// agents are going now, only if the formation and the agents are the same
+	const bool warm = horizonSerial == formationSerial && horizonAgents == agents && horizonPlan.size() == steps;
+	if(!warm)
+		horizonPlan.clear();
+	const std::vector<int> current = warm ? horizonPlan[0] : std::vector<int>(n, -1);
+	const float cost = RollingHorizonAssignment::solve(costs, current, switchPenalty, horizonSweeps, horizonPlan);
+	horizonSerial = formationSerial;
+	horizonAgents = agents;
+
+	permutation = horizonPlan[0];
+	return cost;
+}
+
+Vector2f TaskAssignment::rollingBall(float time) const
+{
+	const Vector2f& velocity = theTeamBallModel.velocity;
+	const float speed = velocity.norm();
+	if(ballFriction >= 0.f || speed == 0.f)
+		return theTeamBallModel.position;
+
+	// constant deceleration until the ball rests
+	const float rollTime = std::min(time, speed / -ballFriction);
+	const Vector2f ball = theTeamBallModel.position +
+			velocity / speed * (speed * rollTime + 0.5f * ballFriction * rollTime * rollTime);
+	return ball.cwiseMax(fieldLowerBound).cwiseMin(fieldLowerBound + fieldSize);
+}
+
+bool TaskAssignment::auctionPosts(const std::vector<std::vector<float> >& costMatrix, int idxOfLeader,
+		int postForLeader, std::vector<int>& permutation)
+{
+	const bool fixed = postForLeader > -1;
+
+	// the robots only take part in the same auction if they agree on all of this; the
+	// leader and its post are left out, so the prices survive when the ball changes cells
+	std::vector<int> bidders = agents;
+	std::sort(bidders.begin(), bidders.end());
+	uint32_t key = AuctionAssignment::hash(AuctionAssignment::emptyKey, formationName);
+	key = AuctionAssignment::hash(key, mirrored);
+	for(int number : bidders)
+		key = AuctionAssignment::hash(key, number);
+	auction.start(key, costMatrix.size());
+
+	for(const AuctionMessage& message : theAuctionMessages.messages)
+		if(message.sender != theRobotInfo.number)
+			auction.merge(message.key, message.phase, message.prices, message.owners);
+
+	// the leader can only bid for its post, the others for all but that one
+	const int me = (int)(std::find(agents.begin(), agents.end(), theRobotInfo.number) - agents.begin());
+	std::vector<float> costs = costMatrix[me];
+	if(fixed)
+		for(size_t j = 0; j < costs.size(); j++)
+			if(((int)j == postForLeader) != (me == idxOfLeader))
+				costs[j] = INFINITY;
+	auction.bid(theRobotInfo.number, costs, bidders);
+
+	if(!auction.converged(bidders) || (fixed && auction.postOf(agents[idxOfLeader]) != postForLeader))
+		return false;
+	permutation.resize(agents.size());
+	for(size_t i = 0; i < agents.size(); i++)
+		permutation[i] = auction.postOf(agents[i]);
+	return true;
+}
+
+int TaskAssignment::lineOfPost(int post) const
+{
+	// tagged posts first, the others by their position in the formation
+	const std::string& name = lastSetFormation[post].name();
+	if(name == "DF")
+		return 0;
+	if(name == "MF")
+		return 1;
+	if(name == "AT" || name == "FW")
+		return 2;
+
+	const float third = theFieldDimensions.xPosOpponentGroundline / 3.f;
+	const float x = lastSetFormation[post].globalPose().translation.x();
+	return x < -third ? 0 : x > third ? 2 : 1;
+}
+
+std::vector<int> TaskAssignment::certificateKey(int postForLeader) const
+{
+	std::vector<int> key;
+	key.push_back((int)formationSerial);
+	key.push_back(leaderID);
+	key.push_back(postForLeader);
+	key.insert(key.end(), agents.begin(), agents.end());
+	return key;
+}
+
+std::vector<int> TaskAssignment::assignmentKey(int postForLeader)
+{
+	const auto quantize = [](float value, float step) { return (int)std::floor(value / step + 0.5f); };
+	const float angleStep = 10_deg;
+
+	std::vector<int> key;
+	key.push_back((int)formationSerial);
+	key.push_back(leaderID);
+	key.push_back(postForLeader);
+
+	// the posts follow the ball only if the transform shifted them
+	key.push_back(lastTransformShifted);
+	key.push_back(lastTransformShifted ? quantize(lastTransformBall.x(), ballCellSize) : 0);
+	key.push_back(lastTransformShifted ? quantize(lastTransformBall.y(), ballCellSize) : 0);
+
+	for(int number : agents)
+	{
+		const Pose2f pose = agentPose(number);
+		key.push_back(number);
+		key.push_back(quantize(pose.translation.x(), poseCellSize));
+		key.push_back(quantize(pose.translation.y(), poseCellSize));
+		key.push_back(quantize(Angle::normalize(pose.rotation), angleStep));
+
+		// the sampled costs depend on the uncertainty, as standard deviations in the same steps
+		if(monteCarloSamples > 0)
+		{
+			const Teammate* teammate = number == theRobotInfo.number ? nullptr : getAgentByPlayerNumber(number);
+			const Matrix3f covariance = number == theRobotInfo.number ? sentCovariance :
+					teammate ? teammate->pose.covariance : Matrix3f::Zero();
+			key.push_back(quantize(std::sqrt(std::max(covariance(0, 0), 0.f)), poseCellSize));
+			key.push_back(quantize(std::sqrt(std::max(covariance(1, 1), 0.f)), poseCellSize));
+			key.push_back(quantize(std::sqrt(std::max(covariance(2, 2), 0.f)), angleStep));
+		}
+	}
+
+	// robots in the way change the costs as well
+	if(obstacleAwareCosts)
+		for(auto& obstacle : theObstacleModel.obstacles)
+		{
+			const Vector2f p = Transformation::robotToField(theRobotPose, obstacle.center);
+			key.push_back(obstacle.type);
+			key.push_back(quantize(p.x(), poseCellSize));
+			key.push_back(quantize(p.y(), poseCellSize));
+		}
+	return key;
+}
+
+std::vector<int> TaskAssignment::speculationKey(const Vector2f& ball, int postForLeader) const
+{
+	std::vector<int> key = certificateKey(postForLeader);
+	key.push_back((int)std::floor(ball.x() / ballCellSize + 0.5f));
+	key.push_back((int)std::floor(ball.y() / ballCellSize + 0.5f));
+	return key;
+}
+
+void TaskAssignment::speculateAssignment(int postForLeader, int idxOfLeader)
+{
+	const Vector2f& ballVelocity = theTeamBallModel.velocity;
+	const float speed = ballVelocity.norm();
+	const bool rolling = lastTransformShifted && ballFriction < 0.f && speed > speculationMinSpeed;
+
+	// the ball stops after v² / 2a under constant friction, the others are
+	// candidates for a ball rolling shorter or longer than the model says
+	static const float rollScales[] = {1.f, 0.7f, 1.3f};
+	const size_t numOfCandidates = sizeof(rollScales) / sizeof(rollScales[0]);
+	speculations.resize(numOfCandidates);
+
+	// a new kick, what was speculated for the last one is outdated
+	if(rolling && !ballRolling)
+		for(AssignmentCertificate& speculation : speculations)
+		{
+			speculationStats.evictions += speculation.empty() ? 0 : 1;
+			speculation.clear();
 		}
+	ballRolling = rolling;
+	if(!rolling)
+		return;
+
+	const size_t candidate = speculationCandidate++ % numOfCandidates;
+	Vector2f rest = theTeamBallModel.position + ballVelocity * (rollScales[candidate] * speed / (-2.f * ballFriction));
+	rest = rest.cwiseMax(fieldLowerBound).cwiseMin(fieldLowerBound + fieldSize);
+
+	const std::vector<int> key = speculationKey(rest, postForLeader);
+	if(speculations[candidate].holds(key))
+		return;
+
+	// posts for the resting ball, the cost functions work on postPositions
+	std::vector<Vector2f> posts;
+	if(activeBallFormation)
+	{
+		int hint = ballFormationTriangle;
+		activeBallFormation->evaluate(rest, posts, hint);
 	}
+	else
+		ballRelativePosts(rest, posts);
+
+	std::vector<std::vector<float> > costMatrix(agents.size(), std::vector<float>(agents.size()));
+	postPositions.swap(posts);
+	costOfRobotToPost(costMatrix, agents);
+	postPositions.swap(posts);
+	if(postForLeader > -1)
+		costMatrix[idxOfLeader][postForLeader] = 0;
+
+	std::vector<int> permutation(agents.size());
+	std::vector<std::vector<float> > reducedCosts;
+	solveAssignment(costMatrix, idxOfLeader, postForLeader, permutation, &reducedCosts);
+	speculations[candidate].certify(key, costMatrix, reducedCosts, permutation);
+}
+
+bool TaskAssignment::speculatedAssignment(int postForLeader, const std::vector<std::vector<float> >& costMatrix,
+		std::vector<int>& permutation)
+{
+	// the ball settled where it was predicted to, but the agents may have moved since
+	if(!speculativeAssignments || !lastTransformShifted || theTeamBallModel.velocity.norm() > speculationRestSpeed)
+		return false;
 
+	const std::vector<int> key = speculationKey(lastTransformBall, postForLeader);
+	for(const AssignmentCertificate& speculation : speculations)
+		if(speculation.holds(key))
+		{
+			if(speculation.covers(key, costMatrix, permutation))
+			{
+				speculationStats.hits++;
+				return true;
+			}
+			speculationStats.misses++;
+		}
+	return false;
 }
 
 void TaskAssignment::updatePost()
 {
 	using namespace std;
 
+	jointRolesSolved = false;
+
 	// static assignment  ---------------------------------------------------------------
 	if (!dynamicPostAssign)
 	{
@@ -353,7 +1216,7 @@ void TaskAssignment::updatePost()
 		try
 		{
 			agentTask.setCurrentAgentVoronoiID(agentVoronoi);
-			agentTask.setCurrentVoronoiPose(agentTask.cell(agentVoronoi).globalPose().translation);
+			agentTask.setCurrentVoronoiPose(postPositions.at(agentVoronoi));
 		}
 		catch(std::out_of_range&)
 		{
@@ -361,10 +1224,14 @@ void TaskAssignment::updatePost()
 			throw(std::out_of_range("agentVoronoi out of range in TaskAssignment::updatePost()"));
 		}
 
+		const size_t numOfPosts = std::min(players.size(), postPositions.size());
+		agentTask.setAssignment(vector<int>(players.begin(), players.begin() + numOfPosts),
+				vector<Vector2f>(postPositions.begin(), postPositions.begin() + numOfPosts));
+
 		LINE("module:TaskAssignment",
 				theRobotPose.translation.x(), theRobotPose.translation.y(),
-				agentTask.cells()[agentVoronoi].globalPose().translation.x(),
-				agentTask.cells()[agentVoronoi].globalPose().translation.y(),
+				postPositions[agentVoronoi].x(),
+				postPositions[agentVoronoi].y(),
 				60, Drawings::solidBrush, ColorRGBA::red);
 		return;
 	}
@@ -394,7 +1261,7 @@ void TaskAssignment::updatePost()
 				{
 					if(teammate.number == leaderID)
 					{
-						int tmpv = agentTask.converToId(teammate.pose);
+						int tmpv = agentTask.converToId(predictedPose(teammate));
 						if(agentTask.cell(tmpv).name() != "DF")
 							postForLeader = tmpv;
 					}
@@ -402,7 +1269,6 @@ void TaskAssignment::updatePost()
 			}
 		}
 
-		vector<int> post(numOfPlayers);
 		//{{{ add present agents counted for post/role assignment
 		agents.clear();
 		for(auto& teammate : theTeammateData.teammates)
@@ -423,20 +1289,8 @@ void TaskAssignment::updatePost()
 			return;
 		}
 
-		// FIXME: sync with voronoi ids in formation files
-		for(size_t i = 0 ; i < post.size(); i++)
-			post[i] = (int)i;
-
-		// FIXME: redundant indexes is used in costMatrix!!!
-		vector<vector<float> > costMatrix;
-		costMatrix.resize(numOfPlayers);
-		for(size_t i = 0; i < costMatrix.size(); i++)
-			costMatrix[i].resize(numOfPlayers);
-
-		costOfRobotToPost(costMatrix, agents);
-
 		// find leader's position in the agent matrix
-		long idxOfLeaderInAgentMatrix;
+		long idxOfLeaderInAgentMatrix = -1;
 		if(postForLeader > -1) // only if any leader exists at all
 		{
 			vector<int>::const_iterator ifoundLeader =
@@ -447,44 +1301,163 @@ void TaskAssignment::updatePost()
 				postForLeader = -1;   // there's going to be a change in leader in current frame (not yet happened) so ignore!
 		}
 
-		// make leader's cost to its voronoi zero (0)
-		if(postForLeader > -1) // only if any leader exists at all
-			costMatrix[idxOfLeaderInAgentMatrix][postForLeader] = 0;
-
-		sort(post.begin(),post.end());	// TODO: seams to be redundant
+		// the leader and the supporter are columns of the same assignment, so the
+		// leader doesn't keep a post of its own then, see jointCosts()
+		const bool joint = jointAssignment && dynamicRoleAssign && hasGotBall();
+		JointLayout layout;
+		if(joint)
+		{
+			postForLeader = -1;
+			idxOfLeaderInAgentMatrix = -1;
+			layout = jointLayout();
+			if(crossingPenalty > 0.f && !crossingIgnoredReported)
+			{
+				cerr << "crossingPenalty is ignored while jointAssignment assigns the roles with the posts" << endl;
+				crossingIgnoredReported = true;
+			}
+		}
 
 		//	std::cout << "numOfPlayers: " << numOfPlayers << std::endl;
 		bestPermutation.clear();
 		bestPermutation.resize(numOfPlayers);
+		vector<int> solution; // column of each row of the cost matrix
 
+		// the quantized team state repeats a lot (e.g. in SET), then neither the
+		// cost matrix nor the solver are needed
 		float globalMin = INFINITY;
+		vector<int> key;
+		if(cacheAssignments)
+		{
+			key = assignmentKey(postForLeader);
+			if(joint)
+				jointKey(layout, key);
+		}
+		bool solved = false;
+
+		// FIXME: redundant indexes is used in costMatrix!!!
+		vector<vector<float> > costMatrix;
+
+		// the robots agree on the posts by bidding with their own costs, the central
+		// solver below is the fallback until the auction converged
+		if(auctionAssignment && !joint)
+		{
+			costMatrix.resize(numOfPlayers, vector<float>(numOfPlayers));
+			costOfRobotToPost(costMatrix, agents);
+			STOPWATCH("TaskAssignment:auction")
+			{
+				solved = auctionPosts(costMatrix, (int)idxOfLeaderInAgentMatrix, postForLeader, solution);
+			}
+			if(solved)
+			{
+				globalMin = 0.f;
+				for(size_t i = 0; i < solution.size(); i++)
+					if(i != (size_t)idxOfLeaderInAgentMatrix)
+						globalMin += costMatrix[i][solution[i]];
+			}
+		}
 
-		do
+		// the plan over the next steps replaces the assignment of this frame alone
+		if(!solved && horizonSteps > 0 && !joint)
 		{
-			/* avoid permutations that is not our desire
-			 * in other words: exclude perms. which leader is not assigned where it
-			 * is meant to. in another words: perform post assignment with rest of the
-			 * available points (one is assigned explicitly to the leader)
-			 */
-			if(postForLeader > -1)
-				if( post[idxOfLeaderInAgentMatrix] != postForLeader)
-					continue;
+			STOPWATCH("TaskAssignment:rollingHorizon")
+			{
+				globalMin = planHorizon(postForLeader, (int)idxOfLeaderInAgentMatrix, solution);
+			}
+			solved = true;
+		}
 
-			float localMin=0;
-			for(unsigned i=0; i<numOfPlayers; i++)
+		solved = solved || (cacheAssignments && assignmentCache.lookup(key, solution, globalMin));
+
+		if(!solved)
+		{
+			// the auction has computed the costs already
+			if(costMatrix.empty())
 			{
-				localMin += costMatrix[i][post[i]];
-				// cout << setprecision(2) << costMatrix[i][post[i]] << "(a" << agent[i] << " -> p" << post[i] << ")" << endl;
+				costMatrix.resize(numOfPlayers);
+				for(size_t i = 0; i < costMatrix.size(); i++)
+					costMatrix[i].resize(numOfPlayers);
+
+				costOfRobotToPost(costMatrix, agents);
 			}
-			// cout << " sum: " << localMin << endl << "------------------" << endl;
 
-			if(localMin < globalMin)
+			// make leader's cost to its voronoi zero (0)
+			if(postForLeader > -1) // only if any leader exists at all
+				costMatrix[idxOfLeaderInAgentMatrix][postForLeader] = 0;
+			if(joint)
+				jointCosts(costMatrix, layout);
+
+			// the costs changed too little to make another assignment optimal
+			vector<int> keyOfCertificate = certificateKey(postForLeader);
+			if(joint)
 			{
-				for (size_t i=0 ; i<post.size(); i++ )
-					bestPermutation[i] = post[i];
-				globalMin = localMin;
+				keyOfCertificate.push_back(layout.ballPost);
+				keyOfCertificate.push_back(layout.withSupporter);
 			}
-		} while(next_permutation(post.begin(), post.end()));
+
+			// while playing the agents only trade adjacent posts, starting from the last
+			// assignment, the global solver is left for new formations, leaders and agents
+			const bool local = neighborhoodCycle >= 2 && !joint && adjacency && theGameInfo.state == STATE_PLAYING &&
+					adjacency->size() == costMatrix.size() && localSearchKey == keyOfCertificate;
+			bool optimal = true;
+			if(local)
+			{
+				solution = localSearchStart;
+				STOPWATCH("TaskAssignment:neighborhoodSearch")
+				{
+					globalMin = NeighborhoodAssignment::improve(costMatrix, *adjacency, neighborhoodCycle,
+							postForLeader > -1 ? (int)idxOfLeaderInAgentMatrix : -1, solution);
+				}
+				optimal = false;
+			}
+			else if(certifyAssignments && assignmentCertificate.covers(keyOfCertificate, costMatrix, solution))
+			{
+				globalMin = 0.f;
+				for(size_t i = 0; i < solution.size(); i++)
+					globalMin += costMatrix[i][solution[i]];
+				assignmentCertificate.stats.certifiedUnchanged++;
+			}
+			else if(!joint && speculatedAssignment(postForLeader, costMatrix, solution))
+			{
+				globalMin = 0.f;
+				for(size_t i = 0; i < solution.size(); i++)
+					globalMin += costMatrix[i][solution[i]];
+			}
+			else
+			{
+				vector<vector<float> > reducedCosts;
+				globalMin = solveAssignment(costMatrix, (int)idxOfLeaderInAgentMatrix, postForLeader, solution,
+						&reducedCosts);
+				assignmentCertificate.certify(keyOfCertificate, costMatrix, reducedCosts, solution);
+				assignmentCertificate.stats.solved++;
+			}
+			// a local optimum must not be returned for the same team state later
+			if(cacheAssignments && optimal)
+				assignmentCache.insert(key, solution, globalMin);
+		}
+
+		if(joint)
+			decodeJointAssignment(solution, layout);
+		else
+		{
+			bestPermutation = solution;
+			localSearchStart = solution;
+			localSearchKey = certificateKey(postForLeader);
+		}
+		MODIFY("module:TaskAssignment:assignmentCache", assignmentCache.stats);
+		MODIFY("module:TaskAssignment:assignmentCertificate", assignmentCertificate.stats);
+
+		if(speculativeAssignments && !joint)
+		{
+			STOPWATCH("TaskAssignment:speculation")
+			{
+				speculateAssignment(postForLeader, (int)idxOfLeaderInAgentMatrix);
+			}
+			MODIFY("module:TaskAssignment:speculations", speculationStats);
+		}
+
+		for(const Vector2f& post : postPositions)
+			CIRCLE("module:TaskAssignment", post.x(), post.y(),
+					50, 10, Drawings::solidPen, ColorRGBA::yellow, Drawings::solidPen, ColorRGBA::black);
 
 		vector<int>::iterator ifound = find(agents.begin(), agents.end(), theRobotInfo.number);
 		long idx = ifound - agents.begin();
@@ -498,47 +1471,192 @@ void TaskAssignment::updatePost()
 
 
 		////OUTPUT_TEXT(theRobotInfo.number << " :: after: " << vID);
-		// FIXME: the second condition of the following if statement is not working in fast game due to
-		// ball is valid flag issues. fix that then fix this so we can only manipulate voronoi points when we've got the ball!
-		if(theGameInfo.state == STATE_PLAYING) // && theWorld.ball().providedLevel() >= MRLBody::Combined)
-		{
-			// TODO: fill in the radius from the gui's input
+		// posts are already shifted relative to the ball by the formation transform (only in playing)
+		agentTask.setCurrentAgentVoronoiID(vID);
+		agentTask.setCurrentVoronoiPose(postPositions[vID]);
 
-			//			Vector2f p = voronoiPoseRelativeToBall(lastSetFormation[vID].globalPose().translation, ballGlobal, Vector2f(750, 500));
-			agentTask.setCurrentVoronoiPose(lastSetFormation[vID].globalPose().translation);
-			agentTask.setCurrentAgentVoronoiID(vID);
-			//			formation.setCurrentVoronoiPose(p);
-
-			//			CIRCLE("module:TaskAssignment",
-			//					p.x(), p.y(),
-			//					50, 10, Drawings::solidBrush, ColorRGBA::black, Drawings::solidBrush, ColorRGBA::black);
-		}
-		else
-		{
-			agentTask.setCurrentAgentVoronoiID(vID);
-			agentTask.setCurrentVoronoiPose(lastSetFormation[vID].globalPose().translation);
-		}
+		// posts of the whole team, e.g. for the pass planner
+		vector<Vector2f> assignedPosts(agents.size());
+		for(size_t i = 0; i < agents.size(); i++)
+			assignedPosts[i] = postPositions[bestPermutation[i]];
+		agentTask.setAssignment(agents, assignedPosts);
 
 		LINE("module:TaskAssignment",
 				theRobotPose.translation.x(), theRobotPose.translation.y(),
-				agentTask.cells()[bestPermutation[idx]].globalPose().translation.x(),
-				agentTask.cells()[bestPermutation[idx]].globalPose().translation.y(),
+				postPositions[bestPermutation[idx]].x(),
+				postPositions[bestPermutation[idx]].y(),
 				60, Drawings::solidBrush, ColorRGBA::red);
 
 		// cout << "\nglobal minimum: " << globalMin << endl;
 #ifndef RELEASE
-		std::vector<VoronoiCell> position = agentTask.cells();
 		for(size_t i=0; i<agents.size(); i++)
 		{
 			DRAWTEXT("module:TaskAssignment",
-					position[bestPermutation[i]].globalPose().translation.x(),
-					position[bestPermutation[i]].globalPose().translation.y(), 100, ColorRGBA::white, agents[i]);
+					postPositions[bestPermutation[i]].x(),
+					postPositions[bestPermutation[i]].y(), 100, ColorRGBA::white, agents[i]);
 			// cout << "a" << agent[i]+2 << "->p" << bestPermutation[i]+1 << "\t";
 		}
 #endif
 	}
 }
 
+TaskAssignment::JointLayout TaskAssignment::jointLayout()
+{
+	JointLayout layout;
+	const Vector2f ball = theGameInfo.state == STATE_PLAYING ? theTeamBallModel.position : Vector2f::Zero();
+
+	// the voronoi cell of the ball is the one of the closest post
+	float closest = std::numeric_limits<float>::infinity();
+	for(size_t j = 0; j < postPositions.size(); j++)
+		if((postPositions[j] - ball).squaredNorm() < closest)
+		{
+			closest = (postPositions[j] - ball).squaredNorm();
+			layout.ballPost = (int)j;
+		}
+
+	// the supporter leaves a post other than a defender's
+	bool postToLeave = false;
+	for(size_t j = 0; j < postPositions.size(); j++)
+		postToLeave |= (int)j != layout.ballPost && agentTask.cell((int)j).name().compare("DF") != 0;
+	layout.withSupporter = layout.ballPost > -1 && postToLeave && palangExpired &&
+			agentTask.cell(layout.ballPost).numOfSup() > 0;
+	return layout;
+}
+
+void TaskAssignment::jointKey(const JointLayout& layout, std::vector<int>& key)
+{
+	const auto quantize = [](float value, float step) { return (int)std::floor(value / step + 0.5f); };
+	key.push_back(layout.ballPost);
+	key.push_back(layout.withSupporter);
+	key.push_back(theGameInfo.state == STATE_PLAYING);
+	key.push_back(quantize(theTeamBallModel.position.x(), ballCellSize));
+	key.push_back(quantize(theTeamBallModel.position.y(), ballCellSize));
+	key.push_back(quantize(theTeamBallModel.velocity.x(), poseCellSize));
+	key.push_back(quantize(theTeamBallModel.velocity.y(), poseCellSize));
+	key.push_back(theFallDownState.state == theFallDownState.upright);
+	for(auto& teammate : theTeammateData.teammates)
+		key.push_back(teammate.status);
+}
+
+void TaskAssignment::jointCosts(std::vector<std::vector<float> >& c, const JointLayout& layout)
+{
+	const size_t n = agents.size();
+	const size_t leaderColumn = n, supporterColumn = n + 1;
+	const size_t size = n + (layout.withSupporter ? 2 : 1);
+
+	// rows behind the agents are vacancies, i.e. the posts nobody takes
+	c.resize(size);
+	for(std::vector<float>& row : c)
+		row.resize(size, forbiddenCost);
+
+	std::vector<Pose2f> poses(n);
+	std::vector<bool> fallen(n);
+	for(size_t i = 0; i < n; i++)
+		if(agents[i] == theRobotInfo.number)
+		{
+			poses[i] = theRobotPose;
+			fallen[i] = theFallDownState.state != theFallDownState.upright;
+		}
+		else
+		{
+			const Teammate* teammate = getAgentByPlayerNumber(agents[i]);
+			ASSERT(teammate);
+			poses[i] = teammate ? predictedPose(*teammate) : Pose2f();
+			fallen[i] = !teammate || teammate->status != Teammate::PLAYING;
+		}
+
+	std::vector<float> interceptTime, interceptX, interceptY;
+	interceptBall(agents, poses, interceptTime, interceptX, interceptY);
+
+	const Vector2f ball = theGameInfo.state == STATE_PLAYING ? theTeamBallModel.position : Vector2f::Zero();
+	const Vector2f supportPoint = ball + supportOffset;
+	for(size_t i = 0; i < n; i++)
+	{
+		// the leader of the last frame keeps leading unless another one is faster by the margin of updateRole
+		const float incumbent = agents[i] != leaderID ? 0.f :
+				hysteresis.position(theGameInfo.state == STATE_READY ? leaderChangedReady : leaderChangedPlaying);
+		const float fallenCost = fallen[i] ? notPlayingCost : 0.f;
+		c[i][leaderColumn] = interceptTime[i] - incumbent + fallenCost;
+
+		if(layout.withSupporter)
+		{
+			const float rotation = Angle::normalize(Vector2f(ball - supportPoint).angle() - poses[i].rotation);
+			c[i][supporterColumn] = motionProfiles.forPlayer(agents[i]).timeToPose(timeCostTable,
+					Transformation::fieldToRobot(poses[i], supportPoint), rotation, robotTranslationSpeed) + fallenCost;
+		}
+	}
+
+	// the leader covers the post of the ball, the supporter leaves another one
+	for(size_t r = n; r < size; r++)
+		for(size_t j = 0; j < n; j++)
+			if((int)j == layout.ballPost)
+				c[r][j] = 0.f;
+			else if(layout.withSupporter && agentTask.cell((int)j).name().compare("DF") != 0)
+				c[r][j] = vacancyCost;
+}
+
+void TaskAssignment::decodeJointAssignment(const std::vector<int>& solution, const JointLayout& layout)
+{
+	const int n = (int)agents.size();
+	const int leaderColumn = n, supporterColumn = n + 1;
+
+	// posts of the vacancies, the one of the ball first
+	std::vector<int> vacated;
+	for(size_t r = n; r < solution.size(); r++)
+		if(solution[r] < n)
+			vacated.push_back(solution[r]);
+	std::stable_partition(vacated.begin(), vacated.end(), [&](int j) { return j == layout.ballPost; });
+	if(vacated.empty())
+		vacated.push_back(std::max(layout.ballPost, 0));
+
+	leaderID = supporterID = -1;
+	bestPermutation.resize(n);
+	for(int i = 0; i < n; i++)
+		if(solution[i] == leaderColumn)
+		{
+			leaderID = agents[i];
+			bestPermutation[i] = vacated.front();
+		}
+		else if(solution[i] == supporterColumn)
+		{
+			supporterID = agents[i];
+			bestPermutation[i] = vacated.back();
+		}
+		else
+			bestPermutation[i] = solution[i];
+	jointRolesSolved = true;
+}
+
+void TaskAssignment::interceptBall(const std::vector<int>& numbers, const std::vector<Pose2f>& poses,
+		std::vector<float>& time, std::vector<float>& x, std::vector<float>& y)
+{
+	// the ball is rolling while playing, so robots are compared by the time to
+	// intercept it rather than by the time to its current position
+	const bool playing = theGameInfo.state == STATE_PLAYING;
+	const Vector2f ball = playing ? theTeamBallModel.position : Vector2f::Zero();
+	const Vector2f ballVelocity = playing ? theTeamBallModel.velocity : Vector2f::Zero();
+
+	const size_t n = numbers.size();
+	std::vector<float> robotX(n), robotY(n), turnTime(n), maxA(n), maxV(n);
+	for(size_t i = 0; i < n; i++)
+	{
+		const MotionProfile& profile = motionProfiles.forPlayer(numbers[i]);
+		robotX[i] = poses[i].translation.x();
+		robotY[i] = poses[i].translation.y();
+		turnTime[i] = timeCostTable(Transformation::fieldToRobot(poses[i], ball).angle(),
+				profile.turning.maxA, profile.turning.maxV);
+		maxA[i] = profile.forward.maxA;
+		maxV[i] = profile.forward.maxV;
+	}
+
+	time.resize(n);
+	x.resize(n);
+	y.resize(n);
+	InterceptSolver::solve(n, robotX.data(), robotY.data(), turnTime.data(),
+			ball, ballVelocity, ballFriction, maxA.data(), maxV.data(),
+			time.data(), x.data(), y.data());
+}
+
 void TaskAssignment::updateRole()
 {
 	bool hasGotTheBall = hasGotBall();
@@ -558,9 +1676,25 @@ void TaskAssignment::updateRole()
 			ballGlobal =
 						Transformation::robotToField(theRobotPose, theBallModel.estimate.position);
 
-			voronoiWithTheBall = agentTask.converToId(ballGlobal, voronoiWithTheBall);
+			// the cell of the last frame is kept unless another one is nearer by the margin, the cells are
+			// the ones of the agents, i.e. around the posts as shifted with the ball
+			int nearest = -1;
+			float nearestDistance = std::numeric_limits<float>::infinity(), lastDistance = nearestDistance;
+			for(size_t i = 0; i < postPositions.size(); i++)
+			{
+				const float distance = (ballGlobal - postPositions[i]).norm();
+				if((int)i == voronoiWithTheBall)
+					lastDistance = distance;
+				else if(distance < nearestDistance)
+				{
+					nearestDistance = distance;
+					nearest = (int)i;
+				}
+			}
+			if(nearest >= 0 && hysteresis.update(ballCellChanged, lastDistance - nearestDistance))
+				voronoiWithTheBall = nearest;
 			leader = (agentTask.getCurrentAgentVoronoiID() == voronoiWithTheBall
-					or theBallModel.estimate.position.norm() < distanceToTargetThre) and hasGotTheBall;
+					or hysteresis.below(ballNearRobot)) and hasGotTheBall;
 		}
 
 		//		OUTPUT(idText, text, formation.converToId(theWorld.ball().globalPose()));
@@ -587,74 +1721,78 @@ void TaskAssignment::updateRole()
 			return;
 		}
 
+		// roles were assigned together with the posts
+		if(jointRolesSolved)
+		{
+			if(leaderID == theRobotInfo.number)
+			{
+				agentTask.setRole(AgentTask::Leader);
+
+				DRAWTEXT("module:TaskAssignment",
+						theRobotPose.translation.x(),
+						theRobotPose.translation.y(),
+						300,ColorRGBA::black, "LD");
+			}
+			else if(supporterID == theRobotInfo.number)
+			{
+				agentTask.setRole(AgentTask::Supporter);
+
+				DRAWTEXT("module:TaskAssignment",
+						theRobotPose.translation.x(),
+						theRobotPose.translation.y(),
+						300,ColorRGBA::white, "SP");
+			}
+			else
+				agentTask.setRole(AgentTask::None);
+			return;
+		}
+
 		std::vector<std::pair<int,float> > robotsToBallCost;
 
-		Vector2f target;
-		float th, td;
+		std::vector<int> candidates;
+		std::vector<Pose2f> candidatePoses;
+		const auto addCandidate = [&](int number, const Pose2f& pose)
+		{
+			candidates.push_back(number);
+			candidatePoses.push_back(pose);
+		};
 
 		if(theRobotInfo.number != 1 &&
 				theFallDownState.state == theFallDownState.upright)
-		{
-			if(theGameInfo.state == STATE_READY || theGameInfo.state == STATE_SET)
-				target = Transformation::fieldToRobot(theRobotPose, Vector2f(0,0));
-			else if(theGameInfo.state == STATE_PLAYING)
-				target = Transformation::fieldToRobot(theRobotPose, theTeamBallModel.position);
-
-			th = timeCost(target.angle(), 0, 0, 0, 0.2f, 0.25f);
-			td = timeCost(target.norm(), 0, 0, 0, 16, 220);
+			addCandidate(theRobotInfo.number, theRobotPose);
 
-			float lowerLastFrameLeaderCost = 0;
+		for(auto& teammate : theTeammateData.teammates)
+		{
+			if(teammate.isGoalkeeper)
+				continue;
 
-			if(leaderID != -1 && theRobotInfo.number == leaderID)
+			if(teammate.status == Teammate::PLAYING)
 			{
-				if(theGameInfo.state == STATE_READY)
-					lowerLastFrameLeaderCost -= 1;	// 1 secs
-				else
-					lowerLastFrameLeaderCost -= 2;	// 1 secs
+				addCandidate(teammate.number, predictedPose(teammate));
+
+				// FIXME: consider start walking from lull
+				/* if(teammate.motionRequest.motion == MotionRequest::stand && target.abs() > distanceToTargetThre)
+						costToBall[i] += 2;
+						if(theRunswiftMotionInfo.actiontype == ActionCommand::Body::STAND && target.norm() > distanceToTargetThre)
+						costToBall[theRobotInfo.number] += 2;
+				 */
 			}
-
-			robotsToBallCost.push_back(std::make_pair(theRobotInfo.number, th+td+lowerLastFrameLeaderCost));
-		}
-
-		for(auto teammate : theTeammateData.teammates)
-		{
-			if(theGameInfo.state == STATE_READY || theGameInfo.state == STATE_SET)
-				target = Transformation::fieldToRobot(teammate.pose, Vector2f(0,0));
-			else if(theGameInfo.state == STATE_PLAYING)
-				target = Transformation::fieldToRobot(teammate.pose, theTeamBallModel.position);
-
-			if(!teammate.isGoalkeeper)
+			else
 			{
-				th = timeCost(target.angle(), 0, 0, 0, 0.2f, 0.25f);
-				td = timeCost(target.norm(), 0, 0, 0, 16, 220);
+				// TODO: more logical value for the fallen robot cost to ball
+				robotsToBallCost.push_back(std::make_pair(teammate.number, notPlayingCost));
+			}
+		}
 
-				float lowerLastFrameLeaderCost = 0;
+		std::vector<float> interceptTime, interceptX, interceptY;
+		interceptBall(candidates, candidatePoses, interceptTime, interceptX, interceptY);
 
-				if(leaderID != -1 && leaderID == teammate.number)
-				{
-					if(theGameInfo.state == STATE_READY)
-						lowerLastFrameLeaderCost -= 1;	// 1 secs
-					else
-						lowerLastFrameLeaderCost -= 2;	// 1 secs
-				}
+		for(size_t i = 0; i < candidates.size(); i++)
+		{
+			robotsToBallCost.push_back(std::make_pair(candidates[i], interceptTime[i]));
 
-				if(teammate.status == Teammate::PLAYING)
-				{
-					robotsToBallCost.push_back(std::make_pair(teammate.number, th+td+lowerLastFrameLeaderCost));
-
-					// FIXME: consider start walking from lull
-					/* if(teammate.motionRequest.motion == MotionRequest::stand && target.abs() > distanceToTargetThre)
-							costToBall[i] += 2;
-							if(theRunswiftMotionInfo.actiontype == ActionCommand::Body::STAND && target.norm() > distanceToTargetThre)
-							costToBall[theRobotInfo.number] += 2;
-					 */
-				}
-				else
-				{
-					// TODO: more logical value for the fallen robot cost to ball
-					robotsToBallCost.push_back(std::make_pair(teammate.number, 1000));
-				}
-			}
+			CROSS("module:TaskAssignment", interceptX[i], interceptY[i], 50, 10, Drawings::solidPen,
+					candidates[i] == leaderID ? ColorRGBA::red : ColorRGBA::orange);
 		}
 
 		// There are times that robotsToBallCost is not filled such as the very
@@ -668,6 +1806,19 @@ void TaskAssignment::updateRole()
 
 		sort(robotsToBallCost.begin(), robotsToBallCost.end(), TaskAssignment::pairCompare);
 
+		// the leader of the last frame stays in front unless another robot is faster by the margin
+		const auto lastLeader = std::find_if(robotsToBallCost.begin(), robotsToBallCost.end(),
+				[&](const std::pair<int,float>& cost) { return cost.first == leaderID; });
+		if(lastLeader != robotsToBallCost.end() && std::find(candidates.begin(), candidates.end(), leaderID) != candidates.end())
+		{
+			const float fastestOther = lastLeader != robotsToBallCost.begin() ? robotsToBallCost[0].second :
+					robotsToBallCost.size() > 1 ? robotsToBallCost[1].second : std::numeric_limits<float>::infinity();
+			const bool changedReady = hysteresis.update(leaderChangedReady, lastLeader->second - fastestOther);
+			const bool changedPlaying = hysteresis.update(leaderChangedPlaying, lastLeader->second - fastestOther);
+			if(!(theGameInfo.state == STATE_READY ? changedReady : changedPlaying))
+				std::rotate(robotsToBallCost.begin(), lastLeader, lastLeader + 1);
+		}
+
 		//		for(std::vector<std::pair<int, float> >::iterator it = robotsToBallCost.begin(); it != robotsToBallCost.end(); ++it)
 		//			OUTPUT(idText, text, (*it).first << "\t" << (*it).second);
 		//		OUTPUT_TEXT("\n------------\n");
@@ -753,7 +1904,7 @@ DF_SUP_BAK_PLAN:
 			}
 		}
 		else if(robotsToBallCost[1].first == theRobotInfo.number && amIDefender &&
-				theTeamBallModel.position.x() < ballInOwnHalfThre &&
+				hysteresis.below(ballInOwnHalf) &&
 				isleaderPoseValid && LeaderPoseX > theTeamBallModel.position.x())	// in case our leader fell behind the opponent (?)
 		{
 			agentTask.setRole(AgentTask::Leader);
@@ -772,128 +1923,6 @@ DF_SUP_BAK_PLAN:
 
 }
 
-float TaskAssignment::timeCost(float x0, float v0, float xf, float vf, float maxA, float maxV)
-{
-	const float dxMin = (vf*vf - v0*v0) / (2.f*maxA*sgn(vf-v0));
-
-	/*
-	 *                            ⎧ ∆X < ∆Xmin => a<0 (1.1)
-	 *          ⎧ ∆X>0 =========> ⎨                          (Special-1)
-	 * (1) ∆V>0 ⎨ ∆X<0 => a<0     ⎩ ∆X > ∆Xmin => a>0 (1.2)
-	 *          ⎩ ∆X=0 => a<0
-	 *
-	 *          ⎧ ∆X>0 => a>0     ⎧ ∆X < ∆Xmin => a<0 (2.1)
-	 * (2) ∆V<0 ⎨ ∆X<0 =========> ⎨                          (Special-2)
-	 *          ⎩ ∆X=0 => a>0     ⎩ ∆X > ∆Xmin => a>0 (2.2)
-	 *
-	 *          ⎧ ∆X>0 => a>0
-	 * (3) ∆V=0 ⎨ ∆X<0 => a<0
-	 *          ⎩ ∆X=0 => a=0 (*)
-	 */
-	const float a = vf>v0?   //-- (1)
-			xf>x0? //-- Special-1
-					xf-x0<dxMin?
-							-maxA: //-- (1.1)
-							+maxA: //-- (1.2)
-							-maxA:
-							vf<v0?   //-- (2)
-									xf<x0? //-- Special-2
-											xf-x0<dxMin?
-													-maxA: //-- (2.1)
-													+maxA: //-- (2.2)
-													+maxA:
-													sgn(xf-x0)*maxA;  //-- (3)
-
-	if (a == 0) return 0; //-- No need to moving
-
-	const float T1 = ((sgn(a)*maxV)/* <=> vMax*/ - v0)/a;
-
-	/*
-	 * k1 = -a*T1 - v0 + vf;
-	 * k2 = (a/2) * T1*T1 - x0 + xf;
-	 * k3 = -k1 / a;
-	 * k4 = a * T1 + v0;
-	 * k5 = (-a/2) * k3*k3 + a * T1 * k3 + v0 * k3 - k2;
-	 * <=>
-	 */
-
-	const float k3 = T1 + (v0 + vf)/a;
-	const float T2 = -((-a/2) * k3*k3 + a * T1 * k3 + v0 * k3 - (a/2) * T1*T1 + x0 - xf) / (a * T1 + v0);
-
-	if(T2 > T1)
-		return T2 + k3;
-	else
-	{
-		/*
-		 * c1 = vf - v0;
-		 * c2 = xf - x0;
-		 * c3 = -c1 / a;
-		 * c4 = 2* v0 / a;
-		 * c5 = - 0.5 * c3*c3 + (v0 * c3) / a - c2 / a;
-		 * delta = c4*c4 - 4 * c5;
-		 * <=>
-		 */
-		const float c3 = (v0 - vf) / a;
-		const float c4 = 2* v0 / a;
-		const float delta = c4*c4 + 2.0f*c3*c3 - 4.0f*((v0*c3)-(xf-x0))/a;
-
-		if(delta > 0)
-			return c3-c4 + (float) sqrt(delta);
-
-		// [TODO] : check this comments, to see if there are any place that T12 need to be used.
-		//      const float T11 = -c4/2 + sqrt(delta)/2;
-		//      const float T12 = -c4/2 - sqrt(delta)/2;
-		//      const float TF1 = 2*T11+c3;
-		//      const float TF2 = 2*T12+c3;
-		//      const float VF1 = -a*TF1 + 2*a*T1 + v0;
-		//      const float VF2 = -a*TF2 + 2*a*T1 + v0;
-		//      if (sgn(VF1) == sgn(vf))
-		//        return TF1;
-		//      else
-		//        return TF2;
-		else if (delta == 0)
-			return c3-c4;
-		else
-			return 0;
-	}
-
-	return 0;
-}
-
-Vector2f TaskAssignment::voronoiPoseRelativeToBall(const Vector2f& VoronoiPose, const Vector2f& BallPosition, const Vector2f& radius)
-{
-	// change voronoi center position relative to ball position in the field
-	// ball differential in the field range is scaled in voronoi range for that specific post/voronoi position
-	// relation => r_p_g(t) = [(r_p_g(t0) - c) * (1 - ∆r_b_g(t,t0))] + [(r_p_g(t0) + c) * ∆r_b_g(t,t0)]
-	// simplified => r_p_g(t) = r_p_g(t0) - c + [2c * ∆r_b_g(t, t0)]
-	// r_p_g: global voronoi position
-	// c: raidus that voronoi position can change
-	// ∆r_b_g: global ball position variation while it is [0, 1]
-	// t0: the initial position, i.e. loaded from the formation in case of voronoi positions
-
-	const Vector2f& posi_voronoi_g = VoronoiPose;
-	const Vector2f& posi_ball_g = BallPosition;
-	const Vector2f& pose_radius_g = radius;
-
-	// TODO: to be loaded from field dimensions
-	float fieldXUpperBound = 4500;
-	float fieldXLowerBound = -4500;
-	float fieldYUpperBound = 3000;
-	float fieldYLowerBound = -3000;
-
-	//		float poseXLowerBound = posi_voronoi_g.x() - std::fabs(pose_radius_g.x());
-	//		float poseXUpperBound = posi_voronoi_g.x() + std::fabs(pose_radius_g.x());
-	//		float poseYLowerBound = posi_voronoi_g.y() - std::fabs(pose_radius_g.y());
-	//		float poseYUpperBound = posi_voronoi_g.y() + std::fabs(pose_radius_g.y());
-
-	// ratio of ball in absolute bound of its lower/upper limits
-	float ballXRatioInAbsBound = (posi_ball_g.x() - fieldXLowerBound)/(fieldXUpperBound-fieldXLowerBound);
-	float ballYRatioInAbsBound = (posi_ball_g.y() - fieldYLowerBound)/(fieldYUpperBound-fieldYLowerBound);
-
-	return Vector2f(posi_voronoi_g.x() - pose_radius_g.x() + 2 * pose_radius_g.x() * ballXRatioInAbsBound,
-			posi_voronoi_g.y() - pose_radius_g.y() + 2 * pose_radius_g.y() * ballYRatioInAbsBound);
-}
-
 unsigned TaskAssignment::lastNumOfPlayers()
 {
 	unsigned num_of_players = 0;
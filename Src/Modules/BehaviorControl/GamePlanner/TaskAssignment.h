@@ -13,7 +13,11 @@
 #pragma once
 
 #include "Tools/Module/Module.h"
-#include "Tools/DynBorder.h"
+#include "Tools/HysteresisBank.h"
+#include "Tools/RingBuffer.h"
+#include "Tools/XorShiftLanes.h"
+#include "Tools/TimeCostTable.h"
+#include "Tools/InterceptSolver.h"
 #include "Representations/Infrastructure/RobotInfo.h"
 #include "Representations/Infrastructure/FrameInfo.h"
 #include "Representations/Infrastructure/GameInfo.h"
@@ -23,9 +27,25 @@
 #include "Representations/Modeling/RobotPose.h"
 #include "Representations/Modeling/BallModel.h"
 #include "Representations/Modeling/TeamBallModel.h"
+#include "Representations/Modeling/ObstacleModel.h"
 #include "Representations/Communication/TeammateData.h"
+#include "Representations/Configuration/FieldDimensions.h"
 #include "Representations/BehaviorControl/AgentTask.h"
+#include "Representations/BehaviorControl/AuctionMessage.h"
+#include "BallConditionedFormation.h"
+#include "FormationCatalog.h"
+#include "MotionProfile.h"
+#include "VisibilityGraph.h"
+#include "LatticeCostTable.h"
+#include "AssignmentCache.h"
+#include "AssignmentCertificate.h"
+#include "HierarchicalAssignment.h"
+#include "BranchAndBoundAssignment.h"
+#include "AuctionAssignment.h"
+#include "RollingHorizonAssignment.h"
+#include "NeighborhoodAssignment.h"
 #include <map>
+#include <memory>
 
 MODULE(TaskAssignment,
 {,
@@ -39,13 +59,51 @@ MODULE(TaskAssignment,
 	REQUIRES(BallModel), // TODO: if not usable remove it totally
 	REQUIRES(TeamBallModel),
 	REQUIRES(TeammateData),
+	REQUIRES(ObstacleModel),
+	REQUIRES(FieldDimensions),
+	USES(AuctionMessages),
 	PROVIDES(AgentTask), // TODO
+	PROVIDES(AuctionMessage),
 	LOADS_PARAMETERS(
 	{,
 		(bool)(false) dynamicPostAssign,
 		(bool)(true) dynamicRoleAssign,
 		(int)(1)			formationVersion,
+		(std::vector<int>)(0, 0)	formationVersions,
+		(int)(5000)		formationDwell,
+		(float)(2.f)	formationMargin,
 		(std::vector<int>)(4, 0)	players,
+		(bool)(true)	watchFormations,
+		(bool)(false) ballRelativeFormation,
+		(Vector2f)(Vector2f(750.f, 500.f)) ballRelativeRadius,
+		(float)(50.f) ballRelativeEpsilon,
+		(float)(-300.f) ballFriction,
+		(int)(200)		teammateLatency,
+		(int)(1000)		maxExtrapolation,
+		(bool)(false) obstacleAwareCosts,
+		(float)(350.f) obstacleRadius,
+		(unsigned)(1000) obstaclePathBudget,
+		(bool)(false) useLatticeCosts,
+		(int)(0)			monteCarloSamples,
+		(float)(0.f)	costQuantile,
+		(Vector2f)(Vector2f(200.f, 0.2f)) poseInflation,
+		(bool)(false)	jointAssignment,
+		(Vector2f)(Vector2f(-1000.f, 0.f)) supportOffset,
+		(unsigned)(0)	hierarchicalAssignment,
+		(float)(0.f)	crossingPenalty,
+		(unsigned)(0)	neighborhoodCycle,
+		(unsigned)(0)	horizonSteps,
+		(int)(1000)		horizonStep,
+		(float)(2.f)	switchPenalty,
+		(unsigned)(3)	horizonSweeps,
+		(bool)(false) auctionAssignment,
+		(Vector2f)(Vector2f(1.f, 0.05f)) auctionEpsilon,
+		(bool)(true)	cacheAssignments,
+		(bool)(true)	certifyAssignments,
+		(bool)(false) speculativeAssignments,
+		(float)(300.f) speculationMinSpeed,
+		(float)(50.f) speculationRestSpeed,
+		(float)(0.1f)	maxTimeCostError,
 	}),
 });
 
@@ -66,12 +124,31 @@ public:
 	 */
   void update(AgentTask& AgentTask);
 
+	/**
+	 * The view of the post auction for the team message
+	 */
+	void update(AuctionMessage& auctionMessage);
+
 private:
 	/**
 	 * Applies general rules of the game
 	 */
   void updateBasicPlan();
 
+	/**
+	 * Columns of the joint role and post assignment besides the posts
+	 */
+	struct JointLayout
+	{
+		int ballPost = -1; /*< post of the voronoi cell the ball is in, covered by the leader */
+		bool withSupporter = false; /*< whether a supporter column exists */
+	};
+
+	/**
+	 * Compares the inputs of the thresholds of the hysteresis bank known at the start of the frame at once
+	 */
+	void updateHysteresis();
+
 	/**
 	 * Updates Formation
 	 *
@@ -89,35 +166,211 @@ private:
 	 */
 	void updateRole();
 
+	/**
+	 * Shifts posts of the active formation relative to the team ball
+	 *
+	 * Formations with ball-conditioned data are interpolated for the ball
+	 * position, others are shifted by ballRelativePosts. Positions are only
+	 * recomputed when the formation has changed or the ball has moved more than
+	 * ballRelativeEpsilon since the last transform.
+	 */
+	void updateFormationTransform();
+
+	/**
+	 * Chooses the version of the formation for the current situation whose
+	 * optimal assignment costs the team least, the candidates are evaluated
+	 * on the thread pool
+	 * @param prefix the name of the formation files of the situation up to the version
+	 * @param catalog the formations to choose from
+	 * @return the version to load
+	 */
+	int selectFormationVersion(const std::string& prefix, const FormationCatalog& catalog);
+
+	/**
+	 * Computes post positions of the active formation for a given ball position
+	 * @param ball global ball position
+	 * @param posts resulting global post positions
+	 */
+	void ballRelativePosts(const Vector2f& ball, std::vector<Vector2f>& posts) const;
+
 	/**
 	 * Checks movement of the ball right after game play
 	 */
 	void calculateHasBallMoved();
 
 	/**
-	 * calculating cost based on rotation, velocity and distance
-	 * @param x0
-	 * @param v0
-	 * @param xf
-	 * @param vf
-	 * @param maxA
-	 * @param maxV
+	 * Finds the assignment of agents to posts with the minimum total cost
+	 * @param costMatrix cost of each agent to each post
+	 * @param idxOfLeader index of the leader among the agents
+	 * @param postForLeader post the leader has to get, -1 if none
+	 * @param permutation resulting post of each agent
+	 * @param reducedCosts if given, the resulting reduced cost of each entry (infinite where the leader is fixed)
+	 * @return the total cost of the assignment
+	 */
+	float solveAssignment(const std::vector<std::vector<float> >& costMatrix, int idxOfLeader, int postForLeader,
+			std::vector<int>& permutation, std::vector<std::vector<float> >* reducedCosts = nullptr) const;
+
+	/**
+	 * Takes part in the distributed post auction with the own row of the costs
+	 * @param costMatrix cost of each agent to each post
+	 * @param idxOfLeader index of the leader among the agents
+	 * @param postForLeader post the leader keeps, -1 if none
+	 * @param permutation resulting post of each agent, only if the auction converged
+	 * @return whether the auction converged, i.e. all robots hold a post within epsilon of the optimum
+	 */
+	bool auctionPosts(const std::vector<std::vector<float> >& costMatrix, int idxOfLeader, int postForLeader,
+			std::vector<int>& permutation);
+
+	/**
+	 * Line of a post for the hierarchical assignment: 0 defence, 1 midfield, 2 attack
+	 */
+	int lineOfPost(int post) const;
+
+	/**
+	 * What an assignment is of apart from the costs, i.e. the formation, the leader and its post and the agents
+	 */
+	std::vector<int> certificateKey(int postForLeader) const;
+
+	/**
+	 * Which role columns the joint assignment has in the current situation
+	 */
+	JointLayout jointLayout();
+
+	/**
+	 * Appends the state the role columns depend on to a cache key, i.e. the
+	 * ball and its velocity and who is fallen
+	 */
+	void jointKey(const JointLayout& layout, std::vector<int>& key);
+
+	/**
+	 * Augments the cost matrix of the posts by the roles to assign them together:
+	 * a leader column (time to intercept the ball), a supporter column (time to
+	 * the support point) and one vacancy row per role for the posts left empty,
+	 * the post of the ball for the leader and any but a defender's for the supporter
+	 * @param c agents x posts, resized to the augmented square matrix
+	 */
+	void jointCosts(std::vector<std::vector<float> >& c, const JointLayout& layout);
+
+	/**
+	 * Sets bestPermutation, leaderID and supporterID from the solution of the
+	 * augmented matrix, the leader and the supporter get the posts left empty
+	 */
+	void decodeJointAssignment(const std::vector<int>& solution, const JointLayout& layout);
+
+	/**
+	 * Time of robots to intercept the team ball (the ball at the center outside of playing)
 	 */
-	float timeCost(float x0, float v0, float xf, float vf, float maxA, float maxV);
+	void interceptBall(const std::vector<int>& numbers, const std::vector<Pose2f>& poses,
+			std::vector<float>& time, std::vector<float>& x, std::vector<float>& y);
+
+	/**
+	 * Quantized team state the post assignment depends on, i.e. the formation,
+	 * the leader, the ball cell, the agent poses and the obstacles if they count
+	 */
+	std::vector<int> assignmentKey(int postForLeader);
+
+	/**
+	 * Key of a speculative assignment, i.e. the formation, the leader, the
+	 * agents and the ball cell, but not the poses which change while the ball rolls
+	 */
+	std::vector<int> speculationKey(const Vector2f& ball, int postForLeader) const;
+
+	/**
+	 * While the ball rolls, solves the assignment for one of the likely resting
+	 * positions of the ball per frame, so it is ready when the ball settles there.
+	 * Each result is kept with its reduced costs and only used once the ball has
+	 * stopped and the result is still optimal for the costs of then (see
+	 * AssignmentCertificate). It runs in the frame, the cost functions share the
+	 * state of the module and the thread pool only runs loops the frame waits for.
+	 * @param postForLeader post the leader has to get, -1 if none
+	 * @param idxOfLeader index of the leader among the agents
+	 */
+	void speculateAssignment(int postForLeader, int idxOfLeader);
+
+	/**
+	 * The speculative assignment for the current ball cell, if the ball has
+	 * stopped and it is still optimal for the current costs
+	 * @param postForLeader post the leader has to get, -1 if none
+	 * @param costMatrix the current costs
+	 * @param permutation the speculated post per agent if so
+	 */
+	bool speculatedAssignment(int postForLeader, const std::vector<std::vector<float> >& costMatrix,
+			std::vector<int>& permutation);
 
 	/**
 	 * Calculates cost of each robot to each post or role
 	 * @param c cost matrix
 	 * @param agent list of agents
+	 * @param poses poses of the agents to start from, e.g. in the future, the current ones if nullptr
+	 */
+	void costOfRobotToPost(std::vector<std::vector<float> > &c, const std::vector<int> &agent,
+			const std::vector<Pose2f>* poses = nullptr);
+
+	/**
+	 * Plans the post assignment over the next horizonSteps steps of predicted
+	 * ball and teammate motion, penalizing switches between the steps
+	 * @param postForLeader post the leader keeps, -1 if none
+	 * @param idxOfLeader index of the leader among the agents
+	 * @param permutation resulting post of each agent in the first step, i.e. now
+	 * @return the total cost of the plan
+	 */
+	float planHorizon(int postForLeader, int idxOfLeader, std::vector<int>& permutation);
+
+	/**
+	 * Position of the team ball after rolling with ballFriction for some time
+	 * @param time the time from now (s)
+	 */
+	Vector2f rollingBall(float time) const;
+
+	/**
+	 * Adds the effect of the pose uncertainty of the agents to the costs, i.e.
+	 * the mean or the costQuantile of the time-to-pose costs of
+	 * monteCarloSamples poses drawn from each agent's covariance minus the cost
+	 * of the pose itself
+	 * @param c cost matrix
+	 * @param agent list of agents
+	 * @param poses poses the costs were computed for
+	 * @param covariances pose covariances (x, y, rotation) of the agents
+	 */
+	void addPoseUncertainty(std::vector<std::vector<float> >& c, const std::vector<int>& agent,
+			const std::vector<Pose2f>& poses, const std::vector<Matrix3f>& covariances);
+
+	/**
+	 * Shortest paths of the agents to the posts around the other robots
+	 * @param agent list of agents
+	 * @param length resulting path length per agent and post
+	 * @param via resulting first waypoint per agent and post
+	 * @param poses poses of the agents if not the current ones, e.g. in a future step
+	 * @return false if obstaclePathBudget was exceeded
 	 */
-	void costOfRobotToPost(std::vector<std::vector<float> > &c, const std::vector<int> &agent);
+	bool obstaclePaths(const std::vector<int>& agent, std::vector<std::vector<float> >& length,
+			std::vector<std::vector<Vector2f> >& via, const std::vector<Pose2f>* poses = nullptr);
 
 	/**
 	 * Get Teammate data based on player number
+	 * @return nullptr if there is no such teammate
 	 */
-	const Teammate& getAgentByPlayerNumber(const int& playerNumber);
+	const Teammate* getAgentByPlayerNumber(int playerNumber) const;
+
+	/**
+	 * Pose of an agent, the own pose for this robot and the predicted pose for a teammate
+	 * @param playerNumber an agent of this frame, i.e. this robot or one of theTeammateData
+	 */
+	Pose2f agentPose(int playerNumber) const;
+
+	/**
+	 * Records the poses received from the teammates and extrapolates them to
+	 * the current time with their velocity, so all robots cost the same poses
+	 * although the messages arrive late
+	 */
+	void updateTeammatePredictions();
+
+	/**
+	 * Pose of a teammate extrapolated to the current frame
+	 * @param teammate the teammate
+	 */
+	Pose2f predictedPose(const Teammate& teammate) const;
 
-	Vector2f voronoiPoseRelativeToBall(const Vector2f& VoronoiPose, const Vector2f& BallPosition, const Vector2f& radius);
 	unsigned lastNumOfPlayers();
 	bool hasGotBall();
 
@@ -147,22 +400,106 @@ private:
 	unsigned lastFrameNumOfPlayers = 0; /*< to determine changes since last frame */
 	uint8_t gameState = 0; /*< hold game state to determine changes since last frame */
 	bool kickoffus; /*< hold kickoffus state to determine changes since last frame */
-	std::map<std::string, std::vector<VoronoiCell> > formations; /*< loaded formations from file */
+	std::shared_ptr<const FormationCatalog> formationCatalog; /*< loaded formations from file, shared by all robots of the process */
+	std::shared_ptr<const FormationCatalog> pendingCatalog; /*< reloaded formations, used once the current formation was loaded from them */
+	std::shared_ptr<FormationWatcher> formationWatcher; /*< rereads the formations when they are edited */
+	bool formationReloaded = false; /*< the catalog changed, the current formation has to be loaded again */
+	bool mirrored = false; /*< whether the formations are mirrored along the x axis */
 	std::vector<VoronoiCell> lastSetFormation; // ?
+	const BallConditionedFormation* activeBallFormation = nullptr; /*< ball-conditioned data of the current formation */
+	const FormationAdjacency* adjacency = nullptr; /*< neighboring posts of the current posts */
+	FormationAdjacency blendedAdjacency; /*< neighboring posts of a ball-conditioned formation for the current ball */
+	int selectedVersion = -1; /*< version of the formation chosen last */
+	std::string selectedPrefix; /*< situation selectedVersion was chosen for, see selectFormationVersion */
+	unsigned versionSelectedTime = 0; /*< when a different version or situation was chosen last */
+	BallConditionedFormation mirroredBallFormation; /*< copy of the current ball-conditioned data when mirrored */
+	int ballFormationTriangle = 0; /*< triangle the ball was located in last frame */
+
+	// formation transform vars --------------------------------------------------
+	std::vector<Vector2f> postPositions; /*< posts of the active formation after the transform */
+	Vector2f lastTransformBall = Vector2f::Zero(); /*< ball position used for the last transform */
+	bool formationTransformDirty = true; /*< forces a transform in the next frame */
+	bool lastTransformShifted = false; /*< whether the last transform was relative to the ball */
+	bool fieldBoundsRead = false;
+	Vector2f fieldLowerBound; /*< lower field bound, read once from the field dimensions */
+	Vector2f fieldSize; /*< size of the field, read once from the field dimensions */
+
+	// teammate prediction vars ------------------------------------------------
+	struct PoseSample
+	{
+		unsigned time; /*< time the pose was received */
+		Pose2f pose;
+	};
+	struct TeammateHistory
+	{
+		int number;
+		RingBuffer<PoseSample, 4> samples; /*< last received poses, newest first */
+	};
+	std::vector<TeammateHistory> teammateHistories;
+	std::vector<int> predictedNumber; /*< player numbers of the predicted poses */
+	std::vector<float> predictedX; /*< predicted poses of the teammates in this frame */
+	std::vector<float> predictedY;
+	std::vector<float> predictedRotation;
+
+	VisibilityGraph visibilityGraph; /*< robots as obstacles, rebuilt for each cost matrix */
 
 	// vars used in post assignment ----------------------------------------------
 	std::vector<int> bestPermutation; /*< result of the post assignment algorithm */
+	AssignmentCache assignmentCache; /*< solved assignments of recent team states */
+	AssignmentCertificate assignmentCertificate; /*< last solved assignment and its slack */
+	std::unique_ptr<ThreadPool> threadPool; /*< threads of the solvers and the formation selection */
+	bool crossingIgnoredReported = false; /*< whether it was reported that the joint matrix has no crossing penalty */
+	static const int numOfLines = 3; /*< defence, midfield, attack */
+	unsigned formationSerial = 0; /*< counts the formations loaded, identifies the current one */
+	std::string formationName; /*< file of the current formation, the same on all robots unlike the serial */
+	AuctionAssignment auction; /*< view of the distributed post auction */
+	std::vector<int> localSearchStart; /*< last post assignment, where the neighborhood search starts from */
+	std::vector<int> localSearchKey; /*< certificate key of localSearchStart */
+	std::vector<std::vector<int> > horizonPlan; /*< post of each agent in each step of the last rolling horizon */
+	std::vector<int> horizonAgents; /*< agents of the last rolling horizon */
+	unsigned horizonSerial = 0; /*< formation of the last rolling horizon */
+	const float poseCellSize = 100.f; /*< quantization of the poses in the cache key (mm) */
+	const float ballCellSize = 250.f; /*< quantization of the ball in the cache key (mm) */
+	std::vector<AssignmentCertificate> speculations; /*< assignments solved ahead for each resting position of the rolling ball */
+	AssignmentCacheStats speculationStats; /*< speculations used, rejected and dropped by a new kick */
+	bool ballRolling = false; /*< whether the ball was fast enough to speculate last frame */
+	unsigned speculationCandidate = 0; /*< resting position to speculate on next */
 	std::vector<int> agents; /*< list of current agents */
 
 	// vars used in role assignment ----------------------------------------------
 	int leaderID = -1; /*< indicates id of the robot that's been leader in the last frame */
+	int supporterID = -1; /*< supporter of the joint assignment, -1 if none */
+	bool jointRolesSolved = false; /*< whether the roles were assigned with the posts in this frame */
+	const float forbiddenCost = 1e5f; /*< cost of entries of the joint assignment that must not be taken (s) */
+	const float vacancyCost = 100.f; /*< cost of leaving a post other than the ball's empty (s) */
+	const float notPlayingCost = 1000.f; /*< time to the ball of a robot that is not playing, e.g. fallen (s) */
 	int voronoiWithTheBall = 0; /*< id of the voronoi which contains the ball */
-	DynBorder<float> ballInOwnHalfThre;
-	DynBorder<float> distanceToTargetThre;
+
+	/**
+	 * Thresholds of the hysteresis bank
+	 */
+	enum Threshold
+	{
+		ballInOwnHalf, /*< the team ball is in our half */
+		ballNearRobot, /*< the ball is close enough to the robot to lead */
+		numOfFrameThresholds, /*< the ones above are compared at the start of the frame */
+		ballCellChanged = numOfFrameThresholds, /*< another voronoi cell is nearer to the ball than the last one by the margin */
+		leaderChangedReady, /*< another robot reaches the ball faster than the last leader by the margin of the ready state */
+		leaderChangedPlaying, /*< the same with the margin of the other states */
+		numOfThresholds
+	};
+	HysteresisBank hysteresis; /*< all thresholds with hysteresis of the module */
 
 	//	char robotTranslationSpeed_x = 0;
 	//	char robotTranslationSpeed_y = 0;
 	const char robotTranslationSpeed = 75;	// TODO: fill it with non-constant value
+	TimeCostTable timeCostTable; /*< interpolated timeCost, built once at construction */
+	MotionProfiles motionProfiles; /*< motion limits per player */
+	LatticeCostTable latticeCosts; /*< cost-to-go of the walk primitives, empty if there is no table */
+	XorShiftLanes<8> random; /*< samples of the pose uncertainty */
+	Matrix3f sentCovariance = Matrix3f::Zero(); /*< own pose covariance of the last team message */
+	unsigned sentCovarianceTime = 0; /*< when sentCovariance was taken */
+	const int teamMessageInterval = 200; /*< ms, 5 team messages per second */
 
 	// ball related vars ---------------------------------------------------------
 	Vector2f ballGlobal;
@@ -0,0 +1,135 @@
+/**
+ * @file VisibilityGraph.cpp
+ *
+ * Shortest paths around circular obstacles (robots)
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "VisibilityGraph.h"
+#include "Tools/Math/BHMath.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void VisibilityGraph::clear()
+{
+	centers.clear();
+	radii.clear();
+	nodes.clear();
+	edges.clear();
+}
+
+void VisibilityGraph::addObstacle(const Vector2f& center, float radius)
+{
+	centers.push_back(center);
+	radii.push_back(radius);
+
+	// the polygon's edges touch the circle, its corners lie a bit outside
+	const float cornerRadius = radius / std::cos(pi / cornersPerObstacle) + 1.f;
+	for(int i = 0; i < cornersPerObstacle; i++)
+	{
+		const float angle = pi2 * i / cornersPerObstacle;
+		nodes.push_back(center + Vector2f(std::cos(angle), std::sin(angle)) * cornerRadius);
+	}
+}
+
+int VisibilityGraph::addWaypoint(const Vector2f& p)
+{
+	nodes.push_back(p);
+	return (int)nodes.size() - 1;
+}
+
+void VisibilityGraph::build()
+{
+	const size_t n = nodes.size();
+	edges.assign(n * n, -1.f);
+
+	// corners inside of another obstacle would let paths slip through it
+	const size_t numOfCorners = centers.size() * cornersPerObstacle;
+	std::vector<bool> usable(n, true);
+	for(size_t i = 0; i < numOfCorners; i++)
+		for(size_t k = 0; k < centers.size(); k++)
+			usable[i] = usable[i] && (nodes[i] - centers[k]).squaredNorm() >= radii[k] * radii[k];
+
+	for(size_t i = 0; i < n; i++)
+	{
+		if(!usable[i])
+			continue;
+
+		// of the corners of its own polygon, a corner only sees its neighbors
+		const size_t obstacle = i / cornersPerObstacle, corner = i % cornersPerObstacle;
+		const size_t nextCorner = obstacle * cornersPerObstacle + (corner + 1) % cornersPerObstacle;
+		if(i < numOfCorners && usable[nextCorner])
+			edges[i * n + nextCorner] = edges[nextCorner * n + i] = (nodes[i] - nodes[nextCorner]).norm();
+
+		const size_t j0 = i < numOfCorners ? (obstacle + 1) * cornersPerObstacle : i + 1;
+		for(size_t j = j0; j < n; j++)
+			if(usable[j] && !blocked(nodes[i], nodes[j]))
+				edges[i * n + j] = edges[j * n + i] = (nodes[i] - nodes[j]).norm();
+	}
+}
+
+bool VisibilityGraph::blocked(const Vector2f& a, const Vector2f& b) const
+{
+	const float abx = b.x() - a.x(), aby = b.y() - a.y();
+	const float inverseLength2 = 1.f / std::max(abx * abx + aby * aby, 1.f);
+	const float minX = std::min(a.x(), b.x()), maxX = std::max(a.x(), b.x());
+	const float minY = std::min(a.y(), b.y()), maxY = std::max(a.y(), b.y());
+	for(size_t k = 0; k < centers.size(); k++)
+	{
+		const float cx = centers[k].x(), cy = centers[k].y(), r = radii[k];
+		if(cx + r < minX || cx - r > maxX || cy + r < minY || cy - r > maxY)
+			continue;
+
+		const float acx = cx - a.x(), acy = cy - a.y();
+		const float bcx = cx - b.x(), bcy = cy - b.y();
+		const float r2 = r * r;
+		if(acx * acx + acy * acy < r2 || bcx * bcx + bcy * bcy < r2)
+			continue;
+
+		const float along = std::max(0.f, std::min(1.f, (acx * abx + acy * aby) * inverseLength2));
+		const float ex = acx - abx * along, ey = acy - aby * along;
+		if(ex * ex + ey * ey < r2)
+			return true;
+	}
+	return false;
+}
+
+void VisibilityGraph::shortestPaths(int source, std::vector<float>& distance, std::vector<int>& next) const
+{
+	// the graph is small and dense, so the plain O(n²) variant is the fastest;
+	// the search ends as soon as all waypoints are settled
+	const float infinity = std::numeric_limits<float>::infinity();
+	const size_t n = nodes.size();
+	const size_t firstWaypoint = centers.size() * cornersPerObstacle;
+	distance.assign(n, infinity);
+	next.assign(n, -1);
+	std::vector<char> done(n, 0);
+	distance[source] = 0.f;
+
+	for(size_t waypointsLeft = n - firstWaypoint; waypointsLeft;)
+	{
+		int u = -1;
+		float best = infinity;
+		for(size_t i = 0; i < n; i++)
+			if(!done[i] && distance[i] < best)
+			{
+				best = distance[i];
+				u = (int)i;
+			}
+		if(u < 0)
+			break;
+
+		done[u] = 1;
+		waypointsLeft -= (size_t)u >= firstWaypoint;
+		const float* edge = edges.data() + u * n;
+		for(size_t i = 0; i < n; i++)
+		{
+			const float d = best + edge[i];
+			const bool shorter = edge[i] >= 0.f && d < distance[i];
+			distance[i] = shorter ? d : distance[i];
+			next[i] = shorter ? u : next[i];
+		}
+	}
+}
@@ -0,0 +1,67 @@
+/**
+ * @file VisibilityGraph.h
+ *
+ * Shortest paths around circular obstacles (robots)
+ *
+ * Every obstacle is replaced by the regular polygon circumscribing its
+ * circle. The corners of the polygons and the added waypoints (agents and
+ * posts) are the nodes of the graph, two nodes are connected if the segment
+ * between them does not cut through a circle. A segment may leave or enter
+ * a circle that contains one of its ends, so robots standing inside of an
+ * inflated obstacle (like an agent inside its own circle) are not locked in.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Math/Eigen.h"
+#include <vector>
+
+class VisibilityGraph
+{
+public:
+	/**
+	 * Removes all obstacles and waypoints
+	 */
+	void clear();
+
+	/**
+	 * Adds a circular obstacle, must be called before the waypoints are added
+	 */
+	void addObstacle(const Vector2f& center, float radius);
+
+	/**
+	 * Adds a waypoint and returns its node index
+	 */
+	int addWaypoint(const Vector2f& p);
+
+	/**
+	 * Connects all nodes that see each other
+	 */
+	void build();
+
+	/**
+	 * Dijkstra from a node
+	 * @param source node to start from
+	 * @param distance resulting path length to each node
+	 * @param next resulting next node on the way back to the source, -1 for the source
+	 */
+	void shortestPaths(int source, std::vector<float>& distance, std::vector<int>& next) const;
+
+	/**
+	 * Whether the segment a-b cuts through an obstacle not containing a or b
+	 */
+	bool blocked(const Vector2f& a, const Vector2f& b) const;
+
+	inline const Vector2f& node(int i) const { return nodes[i]; }
+	inline size_t numOfNodes() const { return nodes.size(); }
+
+	static const int cornersPerObstacle = 6;
+
+private:
+	std::vector<Vector2f> centers; /*< obstacle centers */
+	std::vector<float> radii; /*< obstacle radii */
+	std::vector<Vector2f> nodes; /*< polygon corners followed by the waypoints */
+	std::vector<float> edges; /*< length of the edge between each pair of nodes, negative if blocked */
+};
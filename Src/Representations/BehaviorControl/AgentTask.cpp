@@ -67,6 +67,17 @@ unsigned int AgentTask::converToId(const Pose2f& p, const unsigned& hysID) const
 	return id;
 }
 
+bool AgentTask::getAssignedPost(int playerNumber, Vector2f& post) const
+{
+	for(size_t i = 0; i < _assignedPlayers.size(); i++)
+		if(_assignedPlayers[i] == playerNumber)
+		{
+			post = _assignedPosts[i];
+			return true;
+		}
+	return false;
+}
+
 bool AgentTask::load(const std::string& configAddress)
 {
 	class CFGReader
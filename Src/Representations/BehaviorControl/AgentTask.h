@@ -36,6 +36,7 @@ public:
 	inline void setRole(Role r) { _role = r; }
 	inline void setBallIsFree(bool b) { _ballIsFree = b; }
 	inline void setCurrentVoronoiPose(const Vector2f& p) { _currentVoronoiPose = p; }
+	inline void setAssignment(const std::vector<int>& players, const std::vector<Vector2f>& posts) { _assignedPlayers = players; _assignedPosts = posts; }
 
 	// -- getters
 	inline const std::vector<VoronoiCell> cells() const { return _cells; }
@@ -44,6 +45,7 @@ public:
 	inline Role 			getRole() const { return _role; }
 	inline bool 			getBallIsFree() const { return _ballIsFree; }
 	inline Vector2f 	getCurrentVoronoiPose() const { return _currentVoronoiPose; }
+	bool 							getAssignedPost(int playerNumber, Vector2f& post) const;
 
 	// -- ops
 	const Pose2f& 			converToPoint(const Pose2f& p) const;
@@ -60,6 +62,8 @@ private:
 	int 			_currentVoronoiID;
 	Vector2f 	_currentVoronoiPose;
 	bool 			_ballIsFree;
+	std::vector<int> 			_assignedPlayers; /*< players of the last post assignment */
+	std::vector<Vector2f> _assignedPosts; /*< post position of each assigned player */
 
 	virtual void serialize(In* in, Out* out)
 	{
@@ -69,6 +73,8 @@ private:
 		STREAM(_currentVoronoiPose);
 		STREAM(_ballIsFree);
 		STREAM(_role);
+		STREAM(_assignedPlayers);
+		STREAM(_assignedPosts);
 		STREAM_REGISTER_FINISH;
 	}
 };
@@ -0,0 +1,51 @@
+/**
+ * @file AuctionMessage.h
+ *
+ * View of the distributed post auction of the task assignment, sent with the
+ * team message (see AuctionAssignment.h)
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Streams/Streamable.h"
+#include <vector>
+
+class AuctionMessage : public Streamable
+{
+public:
+	AuctionMessage() : sender(0), key(0), phase(0) {}
+
+	int 			sender; /*< player number of the robot */
+	unsigned 	key; /*< identifies the posts and the bidders of the auction */
+	int 			phase; /*< epsilon scaling phase */
+	std::vector<float> 	prices; /*< price of each post */
+	std::vector<int> 		owners; /*< player number of the highest bidder of each post, 0 if none */
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(sender);
+		STREAM(key);
+		STREAM(phase);
+		STREAM(prices);
+		STREAM(owners);
+		STREAM_REGISTER_FINISH;
+	}
+};
+
+class AuctionMessages : public Streamable
+{
+public:
+	std::vector<AuctionMessage> messages; /*< the last one received from each teammate */
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(messages);
+		STREAM_REGISTER_FINISH;
+	}
+};
@@ -0,0 +1,67 @@
+/**
+ * @file FieldDominance.h
+ *
+ * Coarse raster of the field holding for each cell the earliest time one of
+ * our robots can get there and which robot that is
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Streams/Streamable.h"
+#include "Tools/Math/Eigen.h"
+#include <cmath>
+#include <vector>
+
+class FieldDominance : public Streamable
+{
+public:
+	float 	cellSize = 100.f; /*< edge length of a cell (mm) */
+	Vector2f origin = Vector2f::Zero(); /*< global position of the corner of cell (0, 0) */
+	int 		width = 0; /*< number of cells along x */
+	int 		height = 0; /*< number of cells along y, i.e. number of rows */
+	std::vector<float> arrivalTime; /*< earliest arrival time per cell, row major */
+	std::vector<signed char> fastestRobot; /*< player number of the earliest robot per cell, -1 if none */
+
+	/**
+	 * Index of the cell containing p, -1 outside of the raster
+	 */
+	inline int cellIndex(const Vector2f& p) const
+	{
+		const int x = (int)std::floor((p.x() - origin.x()) / cellSize);
+		const int y = (int)std::floor((p.y() - origin.y()) / cellSize);
+		return x < 0 || y < 0 || x >= width || y >= height ? -1 : y * width + x;
+	}
+
+	/**
+	 * Earliest time one of our robots reaches p, -1 outside of the field
+	 */
+	inline float timeAt(const Vector2f& p) const
+	{
+		const int i = cellIndex(p);
+		return i < 0 ? -1.f : arrivalTime[i];
+	}
+
+	/**
+	 * Player number of the robot that reaches p first, -1 if none
+	 */
+	inline int fastestRobotAt(const Vector2f& p) const
+	{
+		const int i = cellIndex(p);
+		return i < 0 ? -1 : fastestRobot[i];
+	}
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(cellSize);
+		STREAM(origin);
+		STREAM(width);
+		STREAM(height);
+		STREAM(arrivalTime);
+		STREAM(fastestRobot);
+		STREAM_REGISTER_FINISH;
+	}
+};
@@ -0,0 +1,49 @@
+/**
+ * @file PassOptions.h
+ *
+ * Ranked pass targets, result of the pass planner module
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Streams/Streamable.h"
+#include "Tools/Math/Eigen.h"
+#include <vector>
+
+class PassOption : public Streamable
+{
+public:
+	PassOption() : target(Vector2f::Zero()), receiver(-1), score(0.f), receiverTime(0.f) {}
+
+	Vector2f 	target; /*< global position the ball is passed to */
+	int 			receiver; /*< player number of the receiver */
+	float 		score; /*< the higher the better */
+	float 		receiverTime; /*< time the receiver needs to reach the target */
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(target);
+		STREAM(receiver);
+		STREAM(score);
+		STREAM(receiverTime);
+		STREAM_REGISTER_FINISH;
+	}
+};
+
+class PassOptions : public Streamable
+{
+public:
+	std::vector<PassOption> options; /*< best option first */
+
+private:
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(options);
+		STREAM_REGISTER_FINISH;
+	}
+};
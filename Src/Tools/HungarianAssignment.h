@@ -0,0 +1,112 @@
+/**
+ * @file HungarianAssignment.h
+ *
+ * Minimum cost assignment of n rows to n columns with the Hungarian method
+ * (successive shortest augmenting paths, O(n³)).
+ *
+ * Besides the assignment it returns the dual potentials u and v of the linear
+ * program, i.e. c(i, j) - u[i] - v[j] >= 0 for all entries and = 0 for the
+ * assigned ones. These reduced costs tell how much an entry may change before
+ * the assignment stops being optimal.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+class HungarianAssignment
+{
+public:
+	/**
+	 * @param n number of rows and columns
+	 * @param cost callable returning the cost of row i to column j as cost(i, j)
+	 * @param assignment resulting column of each row
+	 * @param u resulting dual potential of each row
+	 * @param v resulting dual potential of each column
+	 * @return the total cost of the assignment
+	 */
+	template<typename Cost>
+	static float solve(size_t n, const Cost& cost, std::vector<int>& assignment, std::vector<float>& u,
+			std::vector<float>& v)
+	{
+		const float infinity = std::numeric_limits<float>::infinity();
+
+		// 1-based, column 0 is the virtual start of each augmenting path
+		std::vector<float> rowPotential(n + 1, 0.f), columnPotential(n + 1, 0.f), minSlack(n + 1);
+		std::vector<int> rowOfColumn(n + 1, 0), previous(n + 1, 0);
+		std::vector<char> visited(n + 1);
+
+		for(size_t row = 1; row <= n; row++)
+		{
+			rowOfColumn[0] = (int)row;
+			int column = 0;
+			std::fill(minSlack.begin(), minSlack.end(), infinity);
+			std::fill(visited.begin(), visited.end(), 0);
+
+			// grow the tree of tight edges until it reaches a free column
+			do
+			{
+				visited[column] = 1;
+				const int i = rowOfColumn[column];
+				int next = 0;
+				float delta = infinity;
+				for(size_t j = 1; j <= n; j++)
+					if(!visited[j])
+					{
+						const float slack = cost(i - 1, j - 1) - rowPotential[i] - columnPotential[j];
+						if(slack < minSlack[j])
+						{
+							minSlack[j] = slack;
+							previous[j] = column;
+						}
+						if(minSlack[j] < delta)
+						{
+							delta = minSlack[j];
+							next = (int)j;
+						}
+					}
+
+				for(size_t j = 0; j <= n; j++)
+					if(visited[j])
+					{
+						rowPotential[rowOfColumn[j]] += delta;
+						columnPotential[j] -= delta;
+					}
+					else
+						minSlack[j] -= delta;
+				column = next;
+			}
+			while(rowOfColumn[column]);
+
+			// flip the path
+			do
+			{
+				const int before = previous[column];
+				rowOfColumn[column] = rowOfColumn[before];
+				column = before;
+			}
+			while(column);
+		}
+
+		assignment.resize(n);
+		u.resize(n);
+		v.resize(n);
+		float total = 0.f;
+		for(size_t j = 1; j <= n; j++)
+		{
+			assignment[rowOfColumn[j] - 1] = (int)j - 1;
+			total += cost(rowOfColumn[j] - 1, j - 1);
+		}
+		for(size_t i = 0; i < n; i++)
+		{
+			u[i] = rowPotential[i + 1];
+			v[i] = columnPotential[i + 1];
+		}
+		return total;
+	}
+};
@@ -0,0 +1,100 @@
+/**
+ * @file HysteresisBank.h
+ *
+ * A number of thresholds with hysteresis (Schmitt triggers), stored as arrays
+ * of positions, radii and signs, so all of them are updated against their
+ * inputs in one loop the compiler vectorizes.
+ *
+ * The border of a threshold is moved away from the input by its radius after
+ * each update, i.e. an input that was above has to fall below position -
+ * radius to become below and vice versa. Before the first update the border
+ * is at the position itself.
+ *
+ * A threshold with radius 0 is a fixed margin. It suits choices that keep the
+ * last one unless another is better by the margin: the input is the advantage
+ * of the best other one, and the hysteresis comes from measuring it against
+ * the last choice. Inputs known only later in the frame are compared one by
+ * one.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include "Tools/Streams/Streamable.h"
+#include <algorithm>
+#include <vector>
+
+class HysteresisBank : public Streamable
+{
+public:
+	/**
+	 * Adds a threshold
+	 * @param position the position of the border
+	 * @param radius how far the border moves away from the input
+	 * @return the index of the threshold
+	 */
+	size_t add(float position, float radius)
+	{
+		positions.push_back(position);
+		radii.push_back(radius);
+		signs.push_back(0.f);
+		return positions.size() - 1;
+	}
+
+	/**
+	 * Compares each input with the border of its threshold and moves the borders
+	 * @param inputs one value per threshold
+	 * @param count number of thresholds updated, the first ones
+	 */
+	void update(const float* inputs, size_t count)
+	{
+		const size_t n = std::min(count, positions.size());
+		const float* position = positions.data();
+		const float* radius = radii.data();
+		float* sign = signs.data();
+		for(size_t i = 0; i < n; i++)
+			sign[i] = inputs[i] > position[i] + radius[i] * sign[i] ? -1.f : 1.f;
+	}
+
+	/**
+	 * Compares the input of a single threshold and moves its border
+	 * @return whether the input is above the border
+	 */
+	bool update(size_t i, float input)
+	{
+		signs[i] = input > positions[i] + radii[i] * signs[i] ? -1.f : 1.f;
+		return above(i);
+	}
+
+	/**
+	 * Whether the input of a threshold was above its border in the last update
+	 */
+	inline bool above(size_t i) const { return signs[i] < 0.f; }
+
+	/**
+	 * Whether the input of a threshold was below its border in the last update
+	 */
+	inline bool below(size_t i) const { return signs[i] > 0.f; }
+
+	/**
+	 * The position of the border of a threshold, i.e. the margin of one with radius 0
+	 */
+	inline float position(size_t i) const { return positions[i]; }
+
+	inline size_t size() const { return positions.size(); }
+
+private:
+	std::vector<float> positions;
+	std::vector<float> radii;
+	std::vector<float> signs; /*< -1 if above, 1 if below, 0 before the first update */
+
+	virtual void serialize(In* in, Out* out)
+	{
+		STREAM_REGISTER_BEGIN;
+		STREAM(positions);
+		STREAM(radii);
+		STREAM(signs);
+		STREAM_REGISTER_FINISH;
+	}
+};
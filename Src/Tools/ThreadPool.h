@@ -0,0 +1,126 @@
+/**
+ * @file ThreadPool.h
+ *
+ * A fixed number of worker threads running the iterations of a parallel for
+ * loop. The calling thread works on the loop as well and returns when all
+ * iterations are done. Iterations are handed out one by one, so uneven ones
+ * are balanced between the threads.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+	/**
+	 * @param numOfThreads number of worker threads besides the calling one
+	 */
+	explicit ThreadPool(unsigned numOfThreads)
+	{
+		for(unsigned i = 0; i < numOfThreads; i++)
+			workers.emplace_back([this] { work(); });
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		wake.notify_all();
+		for(std::thread& worker : workers)
+			worker.join();
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	inline size_t size() const { return workers.size(); }
+
+	/**
+	 * Calls f(i) for all i in [0, n) and returns when all calls are done
+	 */
+	void parallelFor(size_t n, const std::function<void(size_t)>& f)
+	{
+		if(!n)
+			return;
+
+		const std::shared_ptr<Job> current = std::make_shared<Job>(f, n);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = current;
+			generation++;
+		}
+		wake.notify_all();
+
+		run(*current);
+
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [&] { return current->pending == 0; });
+		job.reset();
+	}
+
+private:
+	/**
+	 * A loop, workers that see it late just find no iterations left
+	 */
+	struct Job
+	{
+		Job(const std::function<void(size_t)>& f, size_t n) : f(f), n(n), next(0), pending(n) {}
+
+		std::function<void(size_t)> f;
+		size_t n;
+		std::atomic<size_t> next;
+		std::atomic<size_t> pending;
+	};
+
+	void work()
+	{
+		unsigned seen = 0;
+		std::unique_lock<std::mutex> lock(mutex);
+		while(true)
+		{
+			wake.wait(lock, [&] { return stop || (job && generation != seen); });
+			if(stop)
+				return;
+			seen = generation;
+			const std::shared_ptr<Job> current = job;
+			lock.unlock();
+			run(*current);
+			lock.lock();
+		}
+	}
+
+	void run(Job& current)
+	{
+		size_t finished = 0;
+		for(size_t i; (i = current.next++) < current.n;)
+		{
+			current.f(i);
+			finished++;
+		}
+		if(finished && (current.pending -= finished) == 0)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			done.notify_all();
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	std::shared_ptr<Job> job; /*< the current loop, guarded by mutex */
+	unsigned generation = 0; /*< counts the loops, guarded by mutex */
+	bool stop = false;
+};
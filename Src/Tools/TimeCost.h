@@ -0,0 +1,127 @@
+/**
+ * @file TimeCost.h
+ *
+ * Time needed for a one dimensional motion with limited acceleration and
+ * velocity. Used as motion model for rotation and translation of the robots.
+ *
+ * @author Novin Shahroudi
+ * @author Mohammadreza Hasanzadeh
+ */
+
+#pragma once
+
+#include "Tools/Math/BHMath.h"
+#include <algorithm>
+#include <cmath>
+
+/**
+ * calculating cost based on rotation, velocity and distance
+ * @param x0
+ * @param v0
+ * @param xf
+ * @param vf
+ * @param maxA
+ * @param maxV
+ */
+inline float timeCost(float x0, float v0, float xf, float vf, float maxA, float maxV)
+{
+	const float dxMin = (vf*vf - v0*v0) / (2.f*maxA*sgn(vf-v0));
+
+	/*
+	 *                            ⎧ ∆X < ∆Xmin => a<0 (1.1)
+	 *          ⎧ ∆X>0 =========> ⎨                          (Special-1)
+	 * (1) ∆V>0 ⎨ ∆X<0 => a<0     ⎩ ∆X > ∆Xmin => a>0 (1.2)
+	 *          ⎩ ∆X=0 => a<0
+	 *
+	 *          ⎧ ∆X>0 => a>0     ⎧ ∆X < ∆Xmin => a<0 (2.1)
+	 * (2) ∆V<0 ⎨ ∆X<0 =========> ⎨                          (Special-2)
+	 *          ⎩ ∆X=0 => a>0     ⎩ ∆X > ∆Xmin => a>0 (2.2)
+	 *
+	 *          ⎧ ∆X>0 => a>0
+	 * (3) ∆V=0 ⎨ ∆X<0 => a<0
+	 *          ⎩ ∆X=0 => a=0 (*)
+	 */
+	const float a = vf>v0?   //-- (1)
+			xf>x0? //-- Special-1
+					xf-x0<dxMin?
+							-maxA: //-- (1.1)
+							+maxA: //-- (1.2)
+							-maxA:
+							vf<v0?   //-- (2)
+									xf<x0? //-- Special-2
+											xf-x0<dxMin?
+													-maxA: //-- (2.1)
+													+maxA: //-- (2.2)
+													+maxA:
+													sgn(xf-x0)*maxA;  //-- (3)
+
+	if (a == 0) return 0; //-- No need to moving
+
+	const float T1 = ((sgn(a)*maxV)/* <=> vMax*/ - v0)/a;
+
+	/*
+	 * k1 = -a*T1 - v0 + vf;
+	 * k2 = (a/2) * T1*T1 - x0 + xf;
+	 * k3 = -k1 / a;
+	 * k4 = a * T1 + v0;
+	 * k5 = (-a/2) * k3*k3 + a * T1 * k3 + v0 * k3 - k2;
+	 * <=>
+	 */
+
+	const float k3 = T1 + (v0 + vf)/a;
+	const float T2 = -((-a/2) * k3*k3 + a * T1 * k3 + v0 * k3 - (a/2) * T1*T1 + x0 - xf) / (a * T1 + v0);
+
+	if(T2 > T1)
+		return T2 + k3;
+	else
+	{
+		/*
+		 * c1 = vf - v0;
+		 * c2 = xf - x0;
+		 * c3 = -c1 / a;
+		 * c4 = 2* v0 / a;
+		 * c5 = - 0.5 * c3*c3 + (v0 * c3) / a - c2 / a;
+		 * delta = c4*c4 - 4 * c5;
+		 * <=>
+		 */
+		const float c3 = (v0 - vf) / a;
+		const float c4 = 2* v0 / a;
+		const float delta = c4*c4 + 2.0f*c3*c3 - 4.0f*((v0*c3)-(xf-x0))/a;
+
+		if(delta > 0)
+			return c3-c4 + (float) sqrt(delta);
+
+		// [TODO] : check this comments, to see if there are any place that T12 need to be used.
+		//      const float T11 = -c4/2 + sqrt(delta)/2;
+		//      const float T12 = -c4/2 - sqrt(delta)/2;
+		//      const float TF1 = 2*T11+c3;
+		//      const float TF2 = 2*T12+c3;
+		//      const float VF1 = -a*TF1 + 2*a*T1 + v0;
+		//      const float VF2 = -a*TF2 + 2*a*T1 + v0;
+		//      if (sgn(VF1) == sgn(vf))
+		//        return TF1;
+		//      else
+		//        return TF2;
+		else if (delta == 0)
+			return c3-c4;
+		else
+			return 0;
+	}
+
+	return 0;
+}
+
+/**
+ * Branchless form of timeCost(x, 0, 0, 0, maxA, maxV), i.e. a motion that
+ * starts and ends at rest. Trapezoid profile beyond maxV²/maxA, triangle profile
+ * below it. Suited for evaluating many distances in one loop.
+ * @param x distance (sign is ignored)
+ * @param maxA
+ * @param maxV
+ */
+inline float restToRestTime(float x, float maxA, float maxV)
+{
+	const float d = std::abs(x);
+	const float dCruise = maxV * maxV / maxA;
+	return 2.f * std::sqrt(std::min(d, dCruise) / maxA) + std::max(d - dCruise, 0.f) / maxV;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file XorShiftLanes.h
+ *
+ * A fixed number of independent xorshift32 generators advanced side by side,
+ * so the loops over the lanes are vectorized by the compiler. Normally
+ * distributed numbers are approximated by the sum of four uniform ones
+ * (Irwin-Hall), which needs neither logarithms nor branches.
+ *
+ * @author Novin Shahroudi
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+template<size_t lanes = 8>
+class XorShiftLanes
+{
+public:
+	explicit XorShiftLanes(uint32_t seed = 1) { this->seed(seed); }
+
+	/**
+	 * Restarts all lanes from a seed, equal seeds give equal sequences
+	 */
+	void seed(uint32_t seed)
+	{
+		for(size_t l = 0; l < lanes; l++)
+		{
+			// splitmix32 to decorrelate the lanes, xorshift needs a state != 0
+			uint32_t z = seed + 0x9e3779b9u * (uint32_t)(l + 1);
+			z = (z ^ (z >> 16)) * 0x85ebca6bu;
+			z = (z ^ (z >> 13)) * 0xc2b2ae35u;
+			state[l] = (z ^ (z >> 16)) | 1u;
+		}
+	}
+
+	/**
+	 * Fills n numbers uniformly distributed in [0, 1)
+	 */
+	void uniform(float* out, size_t n)
+	{
+		for(size_t i = 0; i < n; i += lanes)
+		{
+			float block[lanes];
+			next(block);
+			for(size_t l = 0; l < lanes && i + l < n; l++)
+				out[i + l] = block[l];
+		}
+	}
+
+	/**
+	 * Fills n numbers approximately normal distributed with mean 0 and variance 1
+	 */
+	void normal(float* out, size_t n)
+	{
+		for(size_t i = 0; i < n; i += lanes)
+		{
+			float sum[lanes] = {0.f}, block[lanes];
+			for(int k = 0; k < 4; k++)
+			{
+				next(block);
+				for(size_t l = 0; l < lanes; l++)
+					sum[l] += block[l];
+			}
+			// four uniforms have mean 2 and variance 1/3
+			for(size_t l = 0; l < lanes && i + l < n; l++)
+				out[i + l] = (sum[l] - 2.f) * 1.7320508f;
+		}
+	}
+
+private:
+	inline void next(float* block)
+	{
+		for(size_t l = 0; l < lanes; l++)
+		{
+			uint32_t x = state[l];
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			state[l] = x;
+			block[l] = (float)(x >> 8) * (1.f / 16777216.f);
+		}
+	}
+
+	uint32_t state[lanes];
+};
@@ -0,0 +1,258 @@
+/**
+ * @file AuctionSimulator.cpp
+ *
+ * Offline tool running the distributed auction of the task assignment (see
+ * AuctionAssignment.h) for a number of robots on a simulated team message bus
+ * and comparing it with the central solver.
+ *
+ * Each trial places the robots and the posts randomly on the field, the cost
+ * of a robot to a post is its walking time. The robots run at the frame rate
+ * of the behavior and send their view every sendInterval like the team
+ * communication does, starting at random offsets. Each message is lost for
+ * each receiver independently and arrives after the delay plus a random
+ * jitter otherwise. A trial has converged when all robots have converged to
+ * the same assignment.
+ *
+ * As in the game, one robot is the leader and keeps the post of the ball's
+ * cell. The ball changes cells every leaderInterval, which moves the leader's
+ * post and every other time hands the lead to another robot. The robots see
+ * the change at once, and the time until convergence is measured from the last
+ * change. The auction of the task assignment keeps its prices across these
+ * changes and only excludes the leader's post with the costs; for comparison,
+ * the auction is also run restarting from zero prices on every change, as it
+ * would if the leader and its post were part of the key.
+ *
+ * Reported are the time and the number of messages until convergence, the
+ * size of a message and the cost of the result above the optimum of the
+ * Hungarian method, which every robot would compute centrally from the poses
+ * of its teammates without any further messages.
+ *
+ * Build and run:
+ *     g++ -std=c++11 -O2 -ISrc Util/AuctionSimulator/AuctionSimulator.cpp -o AuctionSimulator
+ *     ./AuctionSimulator [robots [trials [leaderChanges [startEpsilon minEpsilon]]]]
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "Modules/BehaviorControl/GamePlanner/AuctionAssignment.h"
+#include "Tools/HungarianAssignment.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const int frameTime = 16; /*< ms, behavior at 60 Hz */
+static const int sendInterval = 200; /*< ms, 5 messages per second */
+static const int jitter = 50; /*< ms */
+static const int timeout = 30000; /*< ms after the last leader change, a trial fails after */
+static const int leaderInterval = 1000; /*< ms between two changes of the ball's cell */
+static const float speed = 220.f; /*< mm/s */
+
+struct Message
+{
+	int sender;
+	int arrival; /*< ms */
+	uint32_t key;
+	int phase;
+	std::vector<float> prices;
+	std::vector<int> owners;
+};
+
+struct Result
+{
+	bool converged;
+	int time; /*< ms until convergence */
+	int messages; /*< sent until convergence */
+	float gap; /*< cost above the optimum */
+	float bound; /*< guaranteed maximum of the gap */
+};
+
+static Result trial(int n, int leaderChanges, bool restart, float startEpsilon, float minEpsilon, float loss, int delay,
+		std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> x(-4500.f, 4500.f), y(-3000.f, 3000.f), uniform(0.f, 1.f);
+	std::uniform_int_distribution<int> offset(0, sendInterval - 1), spread(0, jitter), robot(0, n - 1);
+
+	std::vector<std::vector<float> > costs(n, std::vector<float>(n));
+	{
+		std::vector<float> rx(n), ry(n), px(n), py(n);
+		for(int i = 0; i < n; i++)
+		{
+			rx[i] = x(rng);
+			ry[i] = y(rng);
+			px[i] = x(rng);
+			py[i] = y(rng);
+		}
+		for(int i = 0; i < n; i++)
+			for(int j = 0; j < n; j++)
+				costs[i][j] = std::hypot(rx[i] - px[j], ry[i] - py[j]) / speed;
+	}
+
+	// the leader can only take its post, the others all but that one
+	int leader = robot(rng), leaderPost = robot(rng);
+	std::vector<std::vector<float> > bids = costs;
+	const auto exclude = [&]
+	{
+		for(int i = 0; i < n; i++)
+			for(int j = 0; j < n; j++)
+				bids[i][j] = (j == leaderPost) != (i == leader) ? INFINITY : costs[i][j];
+	};
+	exclude();
+
+	// robots are numbered from 1
+	std::vector<int> bidders(n);
+	for(int i = 0; i < n; i++)
+		bidders[i] = i + 1;
+	std::vector<AuctionAssignment> robots(n, AuctionAssignment(startEpsilon, minEpsilon));
+	std::vector<int> nextSend(n);
+	for(int i = 0; i < n; i++)
+	{
+		robots[i].start(AuctionAssignment::emptyKey, n);
+		nextSend[i] = offset(rng);
+	}
+
+	std::vector<Message> inFlight;
+	Result result = {false, 0, 0, 0.f, n * minEpsilon};
+	const int lastChange = leaderChanges * leaderInterval;
+	for(int now = 0; now < lastChange + timeout; now += frameTime)
+	{
+		if(now > 0 && now <= lastChange && now % leaderInterval < frameTime)
+		{
+			const int change = now / leaderInterval;
+			leaderPost = (leaderPost + 1 + robot(rng) % std::max(n - 1, 1)) % n;
+			if(change % 2 == 0)
+				leader = (leader + 1 + robot(rng) % std::max(n - 1, 1)) % n;
+			exclude();
+			if(restart)
+				for(AuctionAssignment& auction : robots)
+					auction.start(AuctionAssignment::hash(AuctionAssignment::hash(AuctionAssignment::emptyKey, leader),
+							leaderPost), n);
+			result.messages = 0;
+		}
+
+		for(int i = 0; i < n; i++)
+		{
+			for(const Message& message : inFlight)
+				if(message.sender != i + 1 && message.arrival <= now && message.arrival > now - frameTime)
+					robots[i].merge(message.key, message.phase, message.prices, message.owners);
+			robots[i].bid(i + 1, bids[i], bidders);
+		}
+		inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(),
+				[&](const Message& message) { return message.arrival <= now; }), inFlight.end());
+
+		bool agreed = now >= lastChange;
+		for(int i = 0; i < n && agreed; i++)
+			agreed = robots[i].converged(bidders) && robots[i].owners() == robots[0].owners() &&
+					robots[i].postOf(leader + 1) == leaderPost;
+		if(agreed)
+		{
+			std::vector<int> optimal;
+			std::vector<float> u, v;
+			const float optimum = HungarianAssignment::solve(n, [&](size_t i, size_t j)
+			{
+				return std::isfinite(bids[i][j]) ? bids[i][j] : 1e4f;
+			}, optimal, u, v);
+
+			result.converged = true;
+			result.time = now - lastChange;
+			float cost = 0.f;
+			for(int i = 0; i < n; i++)
+				cost += costs[i][robots[0].postOf(i + 1)];
+			result.gap = cost - optimum;
+			return result;
+		}
+
+		// one message per robot to each of the others, lost or delayed independently
+		for(int i = 0; i < n; i++)
+			if(now >= nextSend[i])
+			{
+				nextSend[i] += sendInterval;
+				result.messages++;
+				for(int k = 0; k < n; k++)
+					if(k != i && uniform(rng) >= loss)
+						inFlight.push_back(Message{i + 1, now + delay + spread(rng), robots[i].key(), robots[i].phase(),
+								robots[i].prices(), robots[i].owners()});
+			}
+	}
+	result.time = timeout;
+	return result;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc != 1 && argc != 2 && argc != 3 && argc != 4 && argc != 6)
+	{
+		std::cerr << "usage: " << argv[0] << " [robots [trials [leaderChanges [startEpsilon minEpsilon]]]]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	const int n = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 5;
+	const int trials = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 1000;
+	const int leaderChanges = argc > 3 ? std::max(std::atoi(argv[3]), 0) : 4;
+	const float startEpsilon = argc > 5 ? (float)std::atof(argv[4]) : 1.f;
+	const float minEpsilon = argc > 5 ? (float)std::atof(argv[5]) : 0.05f;
+
+	// as streamed: sender, key, phase and both vectors with their sizes
+	const int messageBytes = 5 * 4 + n * (4 + 4);
+
+	// the central solver, for comparison of the computing time
+	std::mt19937 rng(1);
+	{
+		std::uniform_real_distribution<float> cost(0.f, 40.f);
+		std::vector<std::vector<float> > costs(n, std::vector<float>(n));
+		for(auto& row : costs)
+			for(float& c : row)
+				c = cost(rng);
+		std::vector<int> assignment;
+		std::vector<float> u, v;
+		const int repetitions = 10000;
+		const auto begin = std::chrono::steady_clock::now();
+		for(int r = 0; r < repetitions; r++)
+			HungarianAssignment::solve(n, [&](size_t i, size_t j) { return costs[i][j]; }, assignment, u, v);
+		const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+		std::printf("robots %d, %d leader changes every %d ms, epsilon %.3f .. %.3f s, message %d bytes, "
+				"central solve %.2f us per frame\n\n", n, leaderChanges, leaderInterval, startEpsilon, minEpsilon,
+				messageBytes, us / repetitions);
+	}
+
+	// times and messages are counted from the last leader change
+	std::printf("loss delay  prices  | converged  mean ms  p95 ms  messages  bytes  | mean gap s  max gap s  bound s\n");
+	for(float loss : {0.f, 0.2f, 0.4f})
+		for(int delay : {0, 100, 300})
+			for(bool restart : {false, true})
+			{
+				std::vector<Result> results;
+				for(int t = 0; t < trials; t++)
+					results.push_back(trial(n, leaderChanges, restart, startEpsilon, minEpsilon, loss, delay, rng));
+
+				std::vector<int> times;
+				double messages = 0., gap = 0.;
+				float maxGap = 0.f;
+				for(const Result& result : results)
+					if(result.converged)
+					{
+						times.push_back(result.time);
+						messages += result.messages;
+						gap += result.gap;
+						maxGap = std::max(maxGap, result.gap);
+					}
+				std::sort(times.begin(), times.end());
+				const size_t converged = times.size();
+				double mean = 0.;
+				for(int time : times)
+					mean += time;
+				if(converged)
+				{
+					mean /= converged;
+					messages /= converged;
+					gap /= converged;
+				}
+				std::printf("%4.1f %5d  %-7s | %8.1f%%  %7.0f  %6d  %8.1f  %5.0f  | %10.4f  %9.4f  %7.3f\n",
+						loss, delay, restart ? "restart" : "kept", 100. * converged / trials, mean, converged ? times[converged * 95 / 100] : 0,
+						messages, messages * messageBytes, gap, maxGap, n * minEpsilon);
+			}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file HierarchicalBenchmark.cpp
+ *
+ * Offline tool comparing the line-by-line post assignment (see
+ * HierarchicalAssignment.h) with the exact Hungarian method in time and in the
+ * total cost of the assignment, for growing teams.
+ *
+ * The posts are spread over three lines (defence, midfield, attack) across the
+ * width of a field that grows with the team, the agents stand anywhere on it.
+ * The costs are walking times on straight lines. Reported are the time of both
+ * solvers per assignment, the speedup and the mean and maximum of the cost the
+ * hierarchical assignment adds relative to the optimum.
+ *
+ * Build and run from the B-Human root:
+ *     g++ -std=c++11 -O2 -ISrc Util/HierarchicalBenchmark/HierarchicalBenchmark.cpp \
+ *         Src/Modules/BehaviorControl/GamePlanner/HierarchicalAssignment.cpp -pthread -o HierarchicalBenchmark
+ *     ./HierarchicalBenchmark [runs]
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "Modules/BehaviorControl/GamePlanner/HierarchicalAssignment.h"
+#include "Tools/HungarianAssignment.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const int numOfLines = 3;
+static const float speed = 220.f; /*< mm/s */
+
+int main(int argc, char** argv)
+{
+	if(argc > 2)
+	{
+		std::cerr << "usage: " << argv[0] << " [runs]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	const int runs = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 200;
+
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> uniform(0.f, 1.f);
+
+	std::printf("agents  exact us  hierarchical us  speedup  mean loss %%  max loss %%\n");
+	for(int n : {11, 22, 44, 88, 176})
+	{
+		// the field grows with the team, so every line is about as crowded
+		const float length = 9000.f * std::sqrt(n / 11.f), width = 6000.f * std::sqrt(n / 11.f);
+		std::vector<int> lines(n);
+		std::vector<float> postX(n), postY(n);
+		for(int j = 0; j < n; j++)
+			lines[j] = j * numOfLines / n;
+		for(int j = 0; j < n; j++)
+		{
+			const int inLine = (int)std::count(lines.begin(), lines.begin() + j, lines[j]);
+			const int ofLine = (int)std::count(lines.begin(), lines.end(), lines[j]);
+			postX[j] = length * ((lines[j] + 0.5f) / numOfLines - 0.5f);
+			postY[j] = width * ((inLine + 0.5f) / ofLine - 0.5f);
+		}
+
+		double exactUs = 0., hierarchicalUs = 0., loss = 0., maxLoss = 0.;
+		std::vector<std::vector<float> > costs(n, std::vector<float>(n));
+		std::vector<int> exact, hierarchical;
+		std::vector<float> u, v;
+		for(int r = 0; r < runs; r++)
+		{
+			for(int i = 0; i < n; i++)
+			{
+				const float x = (uniform(rng) - 0.5f) * length, y = (uniform(rng) - 0.5f) * width;
+				for(int j = 0; j < n; j++)
+					costs[i][j] = std::hypot(postX[j] - x, postY[j] - y) / speed;
+			}
+
+			const auto begin = std::chrono::steady_clock::now();
+			const float optimum = HungarianAssignment::solve(n, [&](size_t i, size_t j) { return costs[i][j]; }, exact, u, v);
+			const auto middle = std::chrono::steady_clock::now();
+			const float total = HierarchicalAssignment::solve(costs, lines, numOfLines, nullptr, hierarchical);
+			const auto end = std::chrono::steady_clock::now();
+
+			exactUs += std::chrono::duration<double, std::micro>(middle - begin).count();
+			hierarchicalUs += std::chrono::duration<double, std::micro>(end - middle).count();
+			const double relative = (total - optimum) / optimum * 100.;
+			loss += relative;
+			maxLoss = std::max(maxLoss, relative);
+		}
+
+		std::printf("%6d  %8.1f  %15.1f  %7.2f  %11.1f  %10.1f\n", n, exactUs / runs, hierarchicalUs / runs,
+				exactUs / hierarchicalUs, loss / runs, maxLoss);
+	}
+	return EXIT_SUCCESS;
+}
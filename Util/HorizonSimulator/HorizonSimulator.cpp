@@ -0,0 +1,216 @@
+/**
+ * @file HorizonSimulator.cpp
+ *
+ * Offline tool comparing the post assignment of the current frame alone with
+ * the rolling horizon assignment (see RollingHorizonAssignment.h) in terms of
+ * how often the robots switch their posts.
+ *
+ * Four robots walk to ball-conditioned posts (each post moves a fixed share
+ * of the way towards the ball) for 10 minutes at the frame rate of the
+ * behavior. The ball is kicked into a random direction every 2 s and rolls
+ * with constant friction. The assignment sees the robots with Gaussian noise.
+ * For future steps the ball rolls on and every robot walks straight towards
+ * the post it was sent to, as TaskAssignment::planHorizon does. The costs are
+ * walking times on straight lines.
+ *
+ * Reported are the post switches and the distance walked per minute, the mean
+ * distance of the robots to their posts and the time per frame.
+ *
+ * Build and run from the B-Human root:
+ *     g++ -std=c++11 -O2 -ISrc Util/HorizonSimulator/HorizonSimulator.cpp \
+ *         Src/Modules/BehaviorControl/GamePlanner/RollingHorizonAssignment.cpp -o HorizonSimulator
+ *     ./HorizonSimulator [noise]
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "Modules/BehaviorControl/GamePlanner/RollingHorizonAssignment.h"
+#include "Tools/HungarianAssignment.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const int n = 4; /*< robots and posts */
+static const float frameTime = 1.f / 60.f; /*< s, behavior at 60 Hz */
+static const int frames = 60 * 600; /*< 10 minutes */
+static const int kickInterval = 120; /*< frames */
+static const float speed = 220.f; /*< mm/s */
+static const float friction = -300.f; /*< mm/s² */
+static const float fieldX = 4500.f, fieldY = 3000.f;
+
+struct Point
+{
+	float x, y;
+};
+
+struct Config
+{
+	unsigned steps; /*< future steps besides the current one */
+	float stepTime; /*< s */
+	float penalty; /*< s */
+	unsigned sweeps;
+};
+
+struct Result
+{
+	float switches; /*< per minute */
+	float walked; /*< m per minute */
+	float distance; /*< mean distance to the post (mm) */
+	float time; /*< us per frame */
+};
+
+static std::vector<Point> posts(const Point& ball)
+{
+	static const Point base[n] = {{-3000.f, 0.f}, {-1500.f, 1500.f}, {-1500.f, -1500.f}, {0.f, 0.f}};
+	std::vector<Point> p(n);
+	for(int j = 0; j < n; j++)
+	{
+		const float share = 0.15f + 0.15f * j;
+		p[j] = Point{base[j].x + share * (ball.x - base[j].x), base[j].y + share * (ball.y - base[j].y)};
+	}
+	return p;
+}
+
+// moves a point towards a target by at most a distance, returns the distance moved
+static float walk(Point& from, const Point& to, float maxDistance)
+{
+	const float dx = to.x - from.x, dy = to.y - from.y, d = std::hypot(dx, dy);
+	const float m = std::min(d, maxDistance);
+	if(d > 0.f)
+	{
+		from.x += dx / d * m;
+		from.y += dy / d * m;
+	}
+	return m;
+}
+
+static Result simulate(const Config& config, float noise)
+{
+	std::mt19937 rng(7);
+	std::normal_distribution<float> gauss(0.f, 1.f);
+	std::uniform_real_distribution<float> uniform(0.f, 1.f);
+
+	std::vector<Point> robot(n);
+	for(Point& r : robot)
+		r = Point{(uniform(rng) * 2.f - 1.f) * fieldX, (uniform(rng) * 2.f - 1.f) * fieldY};
+	Point ball = {0.f, 0.f}, velocity = {0.f, 0.f};
+
+	// where the ball is after rolling for some time, as TaskAssignment::rollingBall
+	const auto rolled = [&](float time)
+	{
+		const float s = std::hypot(velocity.x, velocity.y);
+		if(s < 1.f)
+			return ball;
+		const float t = std::min(time, s / -friction);
+		const float d = s * t + 0.5f * friction * t * t;
+		return Point{std::max(-fieldX, std::min(fieldX, ball.x + velocity.x / s * d)),
+				std::max(-fieldY, std::min(fieldY, ball.y + velocity.y / s * d))};
+	};
+
+	std::vector<int> assigned(n, -1), next;
+	std::vector<std::vector<int> > plan;
+	std::vector<float> u, v;
+	long switches = 0;
+	double walked = 0., distance = 0., us = 0.;
+	const size_t steps = config.steps + 1;
+	std::vector<std::vector<std::vector<float> > > costs(steps, std::vector<std::vector<float> >(n, std::vector<float>(n)));
+	for(int f = 0; f < frames; f++)
+	{
+		if(f % kickInterval == 0)
+		{
+			const float angle = uniform(rng) * 6.2831853f, s = 500.f + uniform(rng) * 1000.f;
+			velocity = Point{std::cos(angle) * s, std::sin(angle) * s};
+		}
+
+		// the ball rolls and bounces off the field border
+		const float s = std::hypot(velocity.x, velocity.y);
+		if(s > 0.f)
+		{
+			const float slower = std::max(0.f, s + friction * frameTime) / s;
+			ball.x += velocity.x * frameTime;
+			ball.y += velocity.y * frameTime;
+			velocity.x *= slower;
+			velocity.y *= slower;
+			if(std::abs(ball.x) > fieldX)
+			{
+				velocity.x = -velocity.x;
+				ball.x = std::max(-fieldX, std::min(fieldX, ball.x));
+			}
+			if(std::abs(ball.y) > fieldY)
+			{
+				velocity.y = -velocity.y;
+				ball.y = std::max(-fieldY, std::min(fieldY, ball.y));
+			}
+		}
+
+		std::vector<Point> seen(n), target(n);
+		const std::vector<Point> now = posts(ball);
+		for(int i = 0; i < n; i++)
+		{
+			seen[i] = Point{robot[i].x + noise * gauss(rng), robot[i].y + noise * gauss(rng)};
+			target[i] = assigned[i] >= 0 ? now[assigned[i]] : seen[i];
+		}
+
+		const auto begin = std::chrono::steady_clock::now();
+		for(size_t t = 0; t < steps; t++)
+		{
+			const float time = t * config.stepTime;
+			const std::vector<Point> p = posts(rolled(time));
+			for(int i = 0; i < n; i++)
+			{
+				Point q = seen[i];
+				walk(q, target[i], speed * time);
+				for(int j = 0; j < n; j++)
+					costs[t][i][j] = std::hypot(p[j].x - q.x, p[j].y - q.y) / speed;
+			}
+		}
+		if(config.steps == 0 && config.penalty == 0.f)
+			HungarianAssignment::solve(n, [&](size_t i, size_t j) { return costs[0][i][j]; }, next, u, v);
+		else
+		{
+			RollingHorizonAssignment::solve(costs, assigned, config.penalty, config.sweeps, plan);
+			next = plan[0];
+		}
+		us += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+
+		for(int i = 0; i < n; i++)
+		{
+			if(assigned[i] >= 0 && assigned[i] != next[i])
+				switches++;
+			assigned[i] = next[i];
+			const Point& post = now[assigned[i]];
+			distance += std::hypot(post.x - robot[i].x, post.y - robot[i].y);
+			walked += walk(robot[i], post, speed * frameTime);
+		}
+	}
+	const float minutes = frames * frameTime / 60.f;
+	return Result{switches / minutes, (float)(walked / 1000. / minutes), (float)(distance / frames / n), (float)(us / frames)};
+}
+
+int main(int argc, char** argv)
+{
+	if(argc > 2)
+	{
+		std::cerr << "usage: " << argv[0] << " [noise]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	std::vector<float> noises = {300.f, 100.f};
+	if(argc > 1)
+		noises.assign(1, (float)std::atof(argv[1]));
+
+	const Config configs[] = {{0, 0.f, 0.f, 0}, {0, 0.f, 0.5f, 4}, {0, 0.f, 2.f, 4}, {3, 1.f, 0.5f, 4}, {3, 1.f, 2.f, 4}};
+	std::printf("noise mm  steps  step s  penalty s | switches/min  walked m/min  to post mm  us/frame\n");
+	for(float noise : noises)
+		for(const Config& config : configs)
+		{
+			const Result result = simulate(config, noise);
+			std::printf("%8.0f  %5u  %6.1f  %9.1f | %12.1f  %12.1f  %10.0f  %8.1f\n", noise, config.steps, config.stepTime,
+					config.penalty, result.switches, result.walked, result.distance, result.time);
+		}
+	return EXIT_SUCCESS;
+}
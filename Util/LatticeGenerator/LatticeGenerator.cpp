@@ -0,0 +1,148 @@
+/**
+ * @file LatticeGenerator.cpp
+ *
+ * Offline tool generating the cost-to-go table of a state lattice of walk
+ * primitives for the task assignment (see LatticeCostTable.h).
+ *
+ * States are poses (x, y, rotation) of the robot relative to the goal pose,
+ * discretized in cells of cellSize and numOfAngles headings. The primitives
+ * move the robot to a neighboring cell (including knight moves for a finer
+ * choice of directions), optionally while turning by one heading, or turn it
+ * in place. Their time follows the walk limits: the translation speed comes
+ * from the ellipse through the forward and sideways speeds for the direction
+ * relative to the heading, and turning while walking is bounded by the same
+ * ellipsoid as in MotionProfile::timeToPose. The time to reach the goal from
+ * every state is computed with one backwards Dijkstra search from the goal.
+ *
+ * The table is written quantized to 16 bit (1/100 s) with a small header, so
+ * the robot can map it into memory as it is.
+ *
+ * Build and run:
+ *     g++ -std=c++11 -O2 LatticeGenerator.cpp -o LatticeGenerator
+ *     ./LatticeGenerator latticeCosts.bin [forwardV sidewaysV turningV]
+ *
+ * @author Novin Shahroudi
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// must match LatticeCostTable.h
+struct Header
+{
+	char magic[4]; /*< "LTC1" */
+	int32_t cellsX, cellsY, numOfAngles;
+	float cellSize; /*< mm */
+	float scale; /*< seconds per unit of the stored values */
+	float forwardV; /*< forward speed the table was generated for (mm/s) */
+};
+
+static const float pi = 3.14159265358979f;
+
+int main(int argc, char** argv)
+{
+	if(argc != 2 && argc != 5)
+	{
+		std::cerr << "usage: " << argv[0] << " <output> [forwardV sidewaysV turningV]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	// defaults are the limits of the default motion profile
+	const float forwardV = argc == 5 ? (float)std::atof(argv[2]) : 220.f;
+	const float sidewaysV = argc == 5 ? (float)std::atof(argv[3]) : 220.f;
+	const float turningV = argc == 5 ? (float)std::atof(argv[4]) : 0.25f;
+
+	const float cellSize = 200.f;
+	const int cellsX = 101, cellsY = 101, numOfAngles = 16; // ±10 m around the goal
+	const float scale = 0.01f;
+	const float angleStep = 2.f * pi / numOfAngles;
+
+	const auto index = [&](int x, int y, int a) { return ((size_t)a * cellsY + y) * cellsX + x; };
+
+	// translation primitives as cell offsets
+	std::vector<std::pair<int, int> > moves;
+	for(int dx = -2; dx <= 2; dx++)
+		for(int dy = -2; dy <= 2; dy++)
+			if((dx || dy) && std::abs(dx * dy) != 4 && !(std::abs(dx) == 2 && !dy) && !(std::abs(dy) == 2 && !dx))
+				moves.emplace_back(dx, dy);
+
+	// time of a translation by (dx, dy) cells starting with heading a while turning by da headings
+	const auto primitiveTime = [&](int dx, int dy, int a, int da)
+	{
+		const float heading = a * angleStep;
+		const float gx = dx * cellSize, gy = dy * cellSize;
+		const float rx = std::cos(heading) * gx + std::sin(heading) * gy;
+		const float ry = -std::sin(heading) * gx + std::cos(heading) * gy;
+		const float translation = std::sqrt((rx / forwardV) * (rx / forwardV) + (ry / sidewaysV) * (ry / sidewaysV));
+		const float rotation = std::abs(da) * angleStep / turningV;
+		return std::sqrt(translation * translation + rotation * rotation);
+	};
+
+	const float infinity = std::numeric_limits<float>::infinity();
+	std::vector<float> cost((size_t)cellsX * cellsY * numOfAngles, infinity);
+	typedef std::pair<float, size_t> Entry;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > open;
+
+	const int goalX = cellsX / 2, goalY = cellsY / 2;
+	cost[index(goalX, goalY, 0)] = 0.f;
+	open.push(Entry(0.f, index(goalX, goalY, 0)));
+
+	// backwards: a state s reaches s' = s + move, so s = s' - move
+	while(!open.empty())
+	{
+		const Entry entry = open.top();
+		open.pop();
+		const size_t s = entry.second;
+		if(entry.first > cost[s])
+			continue;
+
+		const int x = (int)(s % cellsX), y = (int)(s / cellsX % cellsY), a = (int)(s / ((size_t)cellsX * cellsY));
+		const auto relax = [&](int px, int py, int pa, float time)
+		{
+			if(px < 0 || py < 0 || px >= cellsX || py >= cellsY)
+				return;
+			const size_t p = index(px, py, (pa + numOfAngles) % numOfAngles);
+			if(entry.first + time < cost[p])
+			{
+				cost[p] = entry.first + time;
+				open.push(Entry(cost[p], p));
+			}
+		};
+
+		for(int da = -1; da <= 1; da++)
+		{
+			const int pa = (a - da + numOfAngles) % numOfAngles;
+			relax(x, y, pa, primitiveTime(0, 0, pa, da));
+			for(const std::pair<int, int>& move : moves)
+				relax(x - move.first, y - move.second, pa, primitiveTime(move.first, move.second, pa, da));
+		}
+	}
+
+	std::vector<uint16_t> values(cost.size());
+	for(size_t i = 0; i < cost.size(); i++)
+		values[i] = (uint16_t)std::min(cost[i] / scale + 0.5f, 65535.f);
+
+	FILE* file = std::fopen(argv[1], "wb");
+	if(!file)
+	{
+		std::cerr << "could not write " << argv[1] << std::endl;
+		return EXIT_FAILURE;
+	}
+	const Header header = {{'L', 'T', 'C', '1'}, cellsX, cellsY, numOfAngles, cellSize, scale, forwardV};
+	std::fwrite(&header, sizeof(header), 1, file);
+	std::fwrite(values.data(), sizeof(uint16_t), values.size(), file);
+	std::fclose(file);
+
+	std::cout << "wrote " << values.size() << " states (" << cellsX << " x " << cellsY << " x " << numOfAngles
+			<< ") to " << argv[1] << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file MotionProfileFitter.cpp
+ *
+ * Offline tool estimating the acceleration and velocity limits of a robot
+ * (forward, sideways and turning) from recorded odometry. The result is a
+ * profile entry for Config/Locations/Default/motionProfiles.cfg.
+ *
+ * Input are CSV files with one odometry sample per line:
+ *     time (ms), x (mm), y (mm), rotation (rad)
+ * e.g. the OdometryData of a log exported line by line. Lines that do not
+ * start with a number (headers) are skipped.
+ *
+ * The velocities are the differences of the samples over a span in the frame
+ * of the robot, the accelerations are the differences of the velocities over
+ * the same span. A limit is the given quantile of the absolute values while
+ * the robot is moving, so single outliers of the odometry do not count.
+ *
+ * Build and run:
+ *     g++ -std=c++11 -O2 MotionProfileFitter.cpp -o MotionProfileFitter
+ *     ./MotionProfileFitter <number> <name> [-q quantile] [-s span] log.csv [log.csv ...]
+ *
+ * @author Novin Shahroudi
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Sample
+{
+	float time; /*< s */
+	float x, y, rotation;
+};
+
+struct Axis
+{
+	std::vector<float> velocity;
+	std::vector<float> acceleration;
+};
+
+static float normalize(float angle)
+{
+	return std::atan2(std::sin(angle), std::cos(angle));
+}
+
+static bool readLog(const char* file, std::vector<Sample>& samples)
+{
+	std::ifstream stream(file);
+	if(!stream.is_open())
+		return false;
+
+	std::string line;
+	while(std::getline(stream, line))
+	{
+		std::replace(line.begin(), line.end(), ',', ' ');
+		std::istringstream fields(line);
+		Sample sample;
+		if(fields >> sample.time >> sample.x >> sample.y >> sample.rotation)
+		{
+			sample.time /= 1000.f;
+			samples.push_back(sample);
+		}
+	}
+
+	std::sort(samples.begin(), samples.end(),
+			[](const Sample& a, const Sample& b) { return a.time < b.time; });
+	samples.erase(std::unique(samples.begin(), samples.end(),
+			[](const Sample& a, const Sample& b) { return a.time == b.time; }), samples.end());
+	return true;
+}
+
+/**
+ * Appends the velocities and accelerations of one log, both are taken as
+ * differences over a span of samples to suppress the noise of the odometry
+ */
+static void differentiate(const std::vector<Sample>& samples, int span, Axis& forward, Axis& sideways, Axis& turning)
+{
+	if((int)samples.size() < 2 * span + 1)
+		return;
+
+	std::vector<float> vx, vy, vr, time;
+	for(size_t i = 0; i + span < samples.size(); i++)
+	{
+		const Sample& a = samples[i];
+		const Sample& b = samples[i + span];
+		const float t = b.time - a.time;
+		const float c = std::cos(a.rotation), s = std::sin(a.rotation);
+		const float dx = b.x - a.x, dy = b.y - a.y;
+		vx.push_back((c * dx + s * dy) / t);
+		vy.push_back((-s * dx + c * dy) / t);
+		vr.push_back(normalize(b.rotation - a.rotation) / t);
+		time.push_back(0.5f * (a.time + b.time));
+	}
+
+	const auto add = [&](const std::vector<float>& v, Axis& axis)
+	{
+		for(size_t i = 0; i + span < v.size(); i++)
+		{
+			axis.velocity.push_back(std::abs(v[i]));
+			axis.acceleration.push_back(std::abs(v[i + span] - v[i]) / (time[i + span] - time[i]));
+		}
+	};
+	add(vx, forward);
+	add(vy, sideways);
+	add(vr, turning);
+}
+
+static float quantile(std::vector<float> values, float q)
+{
+	if(values.empty())
+		return 0.f;
+	const size_t k = std::min(values.size() - 1, (size_t)(q * values.size()));
+	std::nth_element(values.begin(), values.begin() + k, values.end());
+	return values[k];
+}
+
+/**
+ * Limits of one axis, only samples faster than a fraction of the top speed count
+ */
+static void fit(const Axis& axis, float q, float& maxA, float& maxV)
+{
+	maxV = quantile(axis.velocity, q);
+	std::vector<float> moving;
+	for(size_t i = 0; i < axis.velocity.size(); i++)
+		if(axis.velocity[i] > 0.05f * maxV)
+			moving.push_back(axis.acceleration[i]);
+	maxA = quantile(moving, q);
+}
+
+int main(int argc, char** argv)
+{
+	if(argc < 4)
+	{
+		std::cerr << "usage: " << argv[0] << " <number> <name> [-q quantile] [-s span] log.csv [log.csv ...]" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	const int number = std::atoi(argv[1]);
+	const std::string name = argv[2];
+	float q = 0.95f;
+	int span = 25;
+
+	Axis forward, sideways, turning;
+	int logs = 0;
+	for(int i = 3; i < argc; i++)
+	{
+		if(!std::strcmp(argv[i], "-q") && i + 1 < argc)
+			q = (float)std::atof(argv[++i]);
+		else if(!std::strcmp(argv[i], "-s") && i + 1 < argc)
+			span = std::max(1, std::atoi(argv[++i]));
+		else
+		{
+			std::vector<Sample> samples;
+			if(!readLog(argv[i], samples))
+			{
+				std::cerr << "could not read " << argv[i] << std::endl;
+				return EXIT_FAILURE;
+			}
+			differentiate(samples, span, forward, sideways, turning);
+			logs++;
+		}
+	}
+
+	if(!logs || forward.velocity.empty())
+	{
+		std::cerr << "no odometry samples" << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	float forwardA, forwardV, sidewaysA, sidewaysV, turningA, turningV;
+	fit(forward, q, forwardA, forwardV);
+	fit(sideways, q, sidewaysA, sidewaysV);
+	fit(turning, q, turningA, turningV);
+
+	std::printf("{number = %d; name = \"%s\"; forward = {maxA = %.1f; maxV = %.1f;}; "
+			"sideways = {maxA = %.1f; maxV = %.1f;}; turning = {maxA = %.3f; maxV = %.3f;};}\n",
+			number, name.c_str(), forwardA, forwardV, sidewaysA, sidewaysV, turningA, turningV);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file PassPlannerBenchmark.cpp
+ *
+ * Offline tool measuring the scoring of the pass planner (PassScorer, the
+ * core of the PassPlanner module) for several grid spacings, and checking
+ * that scoring the grid in chunks of candidatesPerFrame, as the module does
+ * over several frames, gives the same ranking as scoring it at once.
+ *
+ * Each situation has a random ball, four receivers near random posts and five
+ * opponents on a field of 9 m x 6 m. Reported are the candidates of the grid,
+ * the time to score all of them, the time per candidate, the time of the
+ * ranking and the frames the module needs for the whole grid with the given
+ * budget per frame.
+ *
+ * Build and run from the B-Human root:
+ *     g++ -std=c++11 -O2 -ISrc Util/PassPlannerBenchmark/PassPlannerBenchmark.cpp \
+ *         Src/Modules/BehaviorControl/GamePlanner/PassScorer.cpp -o PassPlannerBenchmark
+ *     ./PassPlannerBenchmark [candidatesPerFrame [situations]]
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "Modules/BehaviorControl/GamePlanner/PassScorer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const float fieldX = 4500.f, fieldY = 3000.f;
+static const int numOfReceivers = 4, numOfOpponents = 5, numOfPassOptions = 5;
+
+struct Situation
+{
+	float ballX, ballY;
+	std::vector<PassScorer::Receiver> receivers;
+	std::vector<PassScorer::Opponent> opponents;
+};
+
+static Situation randomSituation(std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> x(-fieldX, fieldX), y(-fieldY, fieldY), offset(-500.f, 500.f);
+	Situation situation;
+	situation.ballX = x(rng);
+	situation.ballY = y(rng);
+	for(int i = 0; i < numOfReceivers; i++)
+	{
+		const float postX = x(rng), postY = y(rng);
+		situation.receivers.push_back(PassScorer::Receiver{i + 2, postX + offset(rng), postY + offset(rng), postX, postY});
+	}
+	for(int i = 0; i < numOfOpponents; i++)
+		situation.opponents.push_back(PassScorer::Opponent{x(rng), y(rng)});
+	return situation;
+}
+
+int main(int argc, char** argv)
+{
+	if(argc > 3)
+	{
+		std::cerr << "usage: " << argv[0] << " [candidatesPerFrame [situations]]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	const size_t candidatesPerFrame = argc > 1 ? (size_t)std::max(std::atoi(argv[1]), 1) : 256;
+	const int situations = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 1000;
+
+	std::mt19937 rng(7);
+	std::vector<Situation> all;
+	for(int i = 0; i < situations; i++)
+		all.push_back(randomSituation(rng));
+
+	std::printf("spacing mm  candidates  score us  ns/candidate  rank us  frames  chunks agree\n");
+	for(float spacing : {500.f, 250.f, 100.f})
+	{
+		PassScorer whole, chunked;
+		whole.buildGrid(-fieldX + spacing / 2.f, fieldX, -fieldY + spacing / 2.f, fieldY, spacing);
+		chunked.buildGrid(-fieldX + spacing / 2.f, fieldX, -fieldY + spacing / 2.f, fieldY, spacing);
+		const size_t n = whole.size();
+
+		double scoreUs = 0., rankUs = 0.;
+		bool agree = true;
+		std::vector<size_t> best, bestChunked;
+		for(const Situation& s : all)
+		{
+			const auto begin = std::chrono::steady_clock::now();
+			whole.score(0, n, s.ballX, s.ballY, s.receivers, s.opponents);
+			const auto scored = std::chrono::steady_clock::now();
+			whole.rank(numOfPassOptions, best);
+			const auto ranked = std::chrono::steady_clock::now();
+			scoreUs += std::chrono::duration<double, std::micro>(scored - begin).count();
+			rankUs += std::chrono::duration<double, std::micro>(ranked - scored).count();
+
+			for(size_t c = 0; c < n; c += candidatesPerFrame)
+				chunked.score(c, std::min(c + candidatesPerFrame, n), s.ballX, s.ballY, s.receivers, s.opponents);
+			chunked.rank(numOfPassOptions, bestChunked);
+			agree = agree && best == bestChunked;
+		}
+
+		std::printf("%10.0f  %10u  %8.1f  %12.1f  %7.1f  %6u  %12s\n", spacing, (unsigned)n, scoreUs / situations,
+				scoreUs * 1000. / situations / n, rankUs / situations, (unsigned)((n + candidatesPerFrame - 1) / candidatesPerFrame),
+				agree ? "yes" : "no");
+	}
+	return EXIT_SUCCESS;
+}
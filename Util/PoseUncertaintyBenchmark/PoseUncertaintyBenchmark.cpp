@@ -0,0 +1,162 @@
+/**
+ * @file PoseUncertaintyBenchmark.cpp
+ *
+ * Offline tool measuring the Monte Carlo post costs of the task assignment
+ * (TaskAssignment::addPoseUncertainty) for a number of samples per agent, and
+ * checking that the costs of an agent do not depend on the order of the
+ * agents, i.e. that robots listing their teammates differently agree.
+ *
+ * Each run costs random agents with random covariances to random posts with
+ * the same sampling loop as the module: K poses per agent drawn through the
+ * Cholesky factor of its covariance from XorShiftLanes seeded with the player
+ * number, the time-to-pose of the default motion profile for every sample and
+ * post, and the mean over the samples.
+ *
+ * Build and run from the B-Human root:
+ *     g++ -std=c++11 -O2 -ISrc Util/PoseUncertaintyBenchmark/PoseUncertaintyBenchmark.cpp -o PoseUncertaintyBenchmark
+ *     ./PoseUncertaintyBenchmark [agents [repetitions]]
+ *
+ * @author Novin Shahroudi
+ */
+
+#include "Tools/TimeCostTable.h"
+#include "Tools/XorShiftLanes.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// limits of the default MotionProfile
+static const float forwardA = 16.f, forwardV = 220.f, sidewaysA = 16.f, sidewaysV = 220.f;
+static const float turningA = 0.2f, turningV = 0.25f;
+static const float robotTranslationSpeed = 75.f;
+
+struct Agent
+{
+	int number;
+	float x, y, rotation;
+	float l[3][3]; /*< Cholesky factor of the covariance */
+};
+
+struct Post
+{
+	float x, y, rotation;
+};
+
+static float normalize(float angle)
+{
+	while(angle > pi)
+		angle -= 2.f * pi;
+	while(angle < -pi)
+		angle += 2.f * pi;
+	return angle;
+}
+
+// must match MotionProfile::timeToPose
+static float timeToPose(const TimeCostTable& table, float tx, float ty, float rotation)
+{
+	const float d = std::sqrt(tx * tx + ty * ty);
+	const float c = d > 0.f ? tx / d : 1.f, s = d > 0.f ? ty / d : 0.f;
+	const float maxA = forwardA * sidewaysA / std::sqrt(sidewaysA * c * sidewaysA * c + forwardA * s * forwardA * s);
+	const float maxV = forwardV * sidewaysV / std::sqrt(sidewaysV * c * sidewaysV * c + forwardV * s * forwardV * s);
+	const float translationTime = table(d, robotTranslationSpeed, maxA, maxV);
+	const float rotationTime = table(rotation, turningA, turningV);
+	return std::sqrt(translationTime * translationTime + rotationTime * rotationTime);
+}
+
+// the sampling loop of TaskAssignment::addPoseUncertainty, the mean of the samples
+static void sampledCosts(const TimeCostTable& table, XorShiftLanes<8>& random, size_t k, const std::vector<Agent>& agents,
+		const std::vector<Post>& posts, std::vector<std::vector<float> >& c)
+{
+	std::vector<float> z(3 * k), x(k), y(k), r(k);
+	c.assign(agents.size(), std::vector<float>(posts.size()));
+	for(size_t i = 0; i < agents.size(); i++)
+	{
+		const Agent& a = agents[i];
+		random.seed((uint32_t)a.number);
+		random.normal(z.data(), 3 * k);
+		for(size_t s = 0; s < k; s++)
+		{
+			const float z0 = z[s], z1 = z[k + s], z2 = z[2 * k + s];
+			x[s] = a.x + a.l[0][0] * z0;
+			y[s] = a.y + a.l[1][0] * z0 + a.l[1][1] * z1;
+			r[s] = a.rotation + a.l[2][0] * z0 + a.l[2][1] * z1 + a.l[2][2] * z2;
+		}
+		for(size_t j = 0; j < posts.size(); j++)
+		{
+			float sum = 0.f;
+			for(size_t s = 0; s < k; s++)
+			{
+				const float cs = std::cos(r[s]), sn = std::sin(r[s]);
+				const float dx = posts[j].x - x[s], dy = posts[j].y - y[s];
+				sum += timeToPose(table, cs * dx + sn * dy, -sn * dx + cs * dy, normalize(posts[j].rotation - r[s]));
+			}
+			c[i][j] = sum / k;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if(argc > 3)
+	{
+		std::cerr << "usage: " << argv[0] << " [agents [repetitions]]" << std::endl;
+		return EXIT_FAILURE;
+	}
+	const int n = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 5;
+	const int repetitions = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 2000;
+
+	TimeCostTable table;
+	table.build();
+	XorShiftLanes<8> random;
+
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> fieldX(-4500.f, 4500.f), fieldY(-3000.f, 3000.f), angle(-pi, pi);
+	std::uniform_real_distribution<float> sigma(50.f, 500.f), sigmaRotation(0.05f, 0.5f), correlation(-0.5f, 0.5f);
+	std::vector<Agent> agents(n);
+	std::vector<Post> posts(n);
+	for(int i = 0; i < n; i++)
+	{
+		Agent& a = agents[i];
+		a = Agent{i + 2, fieldX(rng), fieldY(rng), angle(rng), {{0.f}}};
+		a.l[0][0] = sigma(rng);
+		a.l[1][0] = correlation(rng) * a.l[0][0];
+		a.l[1][1] = sigma(rng);
+		a.l[2][0] = correlation(rng) * 1e-3f;
+		a.l[2][1] = correlation(rng) * 1e-3f;
+		a.l[2][2] = sigmaRotation(rng);
+		posts[i] = Post{fieldX(rng), fieldY(rng), angle(rng)};
+	}
+
+	std::printf("agents %d, posts %d, %d repetitions\n", n, n, repetitions);
+	std::printf("samples | us per cost matrix  mean cost s | rows equal in reversed agent order\n");
+	for(size_t k : {8, 32, 128})
+	{
+		std::vector<std::vector<float> > c, reversedC;
+		double meanCost = 0.;
+		const auto begin = std::chrono::steady_clock::now();
+		for(int rep = 0; rep < repetitions; rep++)
+		{
+			sampledCosts(table, random, k, agents, posts, c);
+			for(const std::vector<float>& row : c)
+				for(float cost : row)
+					meanCost += cost;
+		}
+		const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+		meanCost /= (double)repetitions * n * n;
+
+		// every robot puts itself last, so the order of the agents differs between the robots
+		std::vector<Agent> reversedAgents(agents.rbegin(), agents.rend());
+		sampledCosts(table, random, k, reversedAgents, posts, reversedC);
+		bool equal = true;
+		for(int i = 0; i < n; i++)
+			equal = equal && c[i] == reversedC[n - 1 - i];
+
+		std::printf("%7zu | %18.2f  %11.3f | %s\n", k, us / repetitions, meanCost, equal ? "yes" : "no");
+	}
+	return EXIT_SUCCESS;
+}